@@ -0,0 +1,156 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ai.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Constructor
+AI::AI(Player side, unsigned int reactionDelay, float aimError, unsigned int seed)
+    : side(side), reactionDelay(reactionDelay), aimError(aimError), random(seed)
+{
+    Reset();
+}
+
+// Forget the current prediction, used when a new match starts
+void AI::Reset()
+{
+    hasPrediction = false;
+    waitFrames = 0;
+    target = WINDOW_HEIGHT / 2.f;
+}
+
+// Compute a new target when the ball bounces, is served or at the first frame
+void AI::Observe(Collision collision, Vector2f ballPosition, Vector2f direction, float speed)
+{
+    if (hasPrediction && collision == None)
+    {
+        return;
+    }
+
+    hasPrediction = true;
+    waitFrames = reactionDelay;
+
+    const bool incoming = side == PlayerLeft ? direction.x < 0 : direction.x > 0;
+
+    if (!incoming)
+    {
+        // Go back to the middle while the opponent plays
+        target = WINDOW_HEIGHT / 2.f;
+        return;
+    }
+
+    // Position of the ball when it touches the racket
+    const float targetX = side == PlayerLeft
+        ? static_cast<float>(DEFAULT_RACKET_L_POS_X + RACKET_L_WIDTH)
+        : DEFAULT_RACKET_R_POS_X - BALL_RADIUS * 2;
+
+    uniform_real_distribution<float> error(-aimError, aimError);
+
+    target = PredictBallY(ballPosition, direction, speed, targetX) + BALL_RADIUS + error(random);
+}
+
+// Press the buttons of the racket to reach the target
+void AI::Control(Input::Button& button, float racketY)
+{
+    bool up = false;
+    bool down = false;
+
+    if (waitFrames > 0)
+    {
+        waitFrames--;
+    }
+    else
+    {
+        const float height = static_cast<float>(side == PlayerLeft ? RACKET_L_HEIGHT : RACKET_R_HEIGHT);
+        const float speed = side == PlayerLeft ? RACKET_L_SPEED : RACKET_R_SPEED;
+        const float racketMiddleY = racketY + height / 2.f;
+
+        // Don't move if the target is closer than one step to avoid shaking
+        up = racketMiddleY - target > speed / 2.f;
+        down = target - racketMiddleY > speed / 2.f;
+    }
+
+    if (side == PlayerLeft)
+    {
+        button.Z = up;
+        button.S = down;
+    }
+    else
+    {
+        button.up = up;
+        button.down = down;
+    }
+}
+
+float AI::GetTarget() const
+{
+    return target;
+}
+
+// Y position of the ball at the frame it reaches targetX.
+// The trajectory is unfolded one wall segment at a time, with the ball clamped
+// against the top and bottom of the window like Intersect() does, so the cost
+// depends on the number of bounces and not on the distance.
+float AI::PredictBallY(Vector2f ballPosition, Vector2f direction, float speed, float targetX)
+{
+    const float stepX = direction.x * speed;
+    const float minY = 0.f;
+    const float maxY = WINDOW_HEIGHT - BALL_RADIUS * 2;
+
+    float y = ballPosition.y;
+    float stepY = direction.y * -1 * speed;
+
+    if (stepX == 0.f || (targetX - ballPosition.x) / stepX <= 0.f)
+    {
+        return y;
+    }
+
+    // Number of frames before the ball reaches the racket
+    long frames = static_cast<long>(ceil((targetX - ballPosition.x) / stepX));
+
+    while (frames > 0)
+    {
+        if (stepY == 0.f)
+        {
+            break;
+        }
+
+        const float distance = stepY < 0.f ? y - minY : maxY - y;
+        const long framesToWall = max(1L, static_cast<long>(ceil(distance / fabs(stepY))));
+
+        if (framesToWall > frames)
+        {
+            y += stepY * static_cast<float>(frames);
+            break;
+        }
+
+        y = stepY < 0.f ? minY : maxY;
+        stepY = -stepY;
+        frames -= framesToWall;
+    }
+
+    return y;
+}
@@ -0,0 +1,356 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "archive.h"
+
+#include "hash.h"
+#include "settings.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Header : magic, version, number of files
+// Index : for each file, length of the name, name, offset, size and xxHash64 of the data
+// Data : each file aligned on ARCHIVE_ALIGNMENT bytes
+const char ARCHIVE_MAGIC[4]{ 'P', 'P', 'A', 'K' };
+const uint32_t ARCHIVE_VERSION{ 1 };
+const size_t ARCHIVE_HEADER_SIZE{ 12 };
+const size_t ARCHIVE_ALIGNMENT{ 16 };
+
+static void Write32(vector<unsigned char>& bytes, uint32_t value)
+{
+    for (int index = 0; index < 4; index++)
+    {
+        bytes.push_back(static_cast<unsigned char>(value >> (index * 8)));
+    }
+}
+
+static uint32_t Read32(const unsigned char* bytes)
+{
+    uint32_t value = 0;
+
+    for (int index = 0; index < 4; index++)
+    {
+        value |= static_cast<uint32_t>(bytes[index]) << (index * 8);
+    }
+    return value;
+}
+
+Archive::Archive() : data(nullptr), size(0)
+#if defined(_WIN32)
+    , file(INVALID_HANDLE_VALUE), mapping(nullptr)
+#endif
+{
+}
+
+Archive::~Archive()
+{
+    Close();
+}
+
+bool Archive::Open(const string& fileName)
+{
+    Close();
+
+#if defined(_WIN32)
+    file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER fileSize;
+
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(ARCHIVE_HEADER_SIZE))
+    {
+        Close();
+        return false;
+    }
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+    if (!view)
+    {
+        Close();
+        return false;
+    }
+
+    data = static_cast<const unsigned char*>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int descriptor = open(fileName.c_str(), O_RDONLY);
+    struct stat status;
+
+    if (descriptor < 0)
+    {
+        return false;
+    }
+
+    if (fstat(descriptor, &status) != 0 || status.st_size < static_cast<off_t>(ARCHIVE_HEADER_SIZE))
+    {
+        close(descriptor);
+        return false;
+    }
+
+    // The mapping stays valid after the file is closed
+    void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+
+    if (view == MAP_FAILED)
+    {
+        return false;
+    }
+
+    data = static_cast<const unsigned char*>(view);
+    size = static_cast<size_t>(status.st_size);
+#endif
+
+    if (!ReadIndex())
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void Archive::Close()
+{
+    entries.clear();
+
+#if defined(_WIN32)
+    if (data)
+    {
+        UnmapViewOfFile(data);
+    }
+    if (mapping)
+    {
+        CloseHandle(mapping);
+    }
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file);
+    }
+    mapping = nullptr;
+    file = INVALID_HANDLE_VALUE;
+#else
+    if (data)
+    {
+        munmap(const_cast<unsigned char*>(data), size);
+    }
+#endif
+
+    data = nullptr;
+    size = 0;
+}
+
+bool Archive::IsOpen() const
+{
+    return data != nullptr;
+}
+
+Archive::Entry Archive::Find(const string& name) const
+{
+    const auto entry = entries.find(name);
+    return entry != entries.end() ? entry->second : Entry{ nullptr, 0 };
+}
+
+size_t Archive::GetEntryCount() const
+{
+    return entries.size();
+}
+
+// Check the header and the bounds of each entry, and the hash of its data
+bool Archive::ReadIndex()
+{
+    if (!equal(ARCHIVE_MAGIC, ARCHIVE_MAGIC + 4, data) || Read32(data + 4) != ARCHIVE_VERSION)
+    {
+        return false;
+    }
+
+    const uint32_t count = Read32(data + 8);
+    size_t position = ARCHIVE_HEADER_SIZE;
+
+    for (uint32_t index = 0; index < count; index++)
+    {
+        if (size - position < 4 || size - position - 4 < Read32(data + position) + 16ull)
+        {
+            return false;
+        }
+
+        const uint32_t nameLength = Read32(data + position);
+        const string name(reinterpret_cast<const char*>(data + position + 4), nameLength);
+        position += 4 + nameLength;
+
+        const uint32_t offset = Read32(data + position);
+        const uint32_t entrySize = Read32(data + position + 4);
+        const unsigned long long hash = static_cast<unsigned long long>(Read32(data + position + 8)) | static_cast<unsigned long long>(Read32(data + position + 12)) << 32;
+        position += 16;
+
+        if (offset > size || entrySize > size - offset || XxHash64(data + offset, entrySize) != hash)
+        {
+            return false;
+        }
+
+        entries[name] = { data + offset, entrySize };
+    }
+    return true;
+}
+
+bool Archive::Pack(const string& directory, const string& fileName)
+{
+    vector<filesystem::path> files;
+    error_code error;
+
+    for (const filesystem::directory_entry& entry : filesystem::recursive_directory_iterator(directory, error))
+    {
+        if (entry.is_regular_file())
+        {
+            files.push_back(entry.path());
+        }
+    }
+
+    if (error)
+    {
+        return false;
+    }
+
+    // Same archive for the same files
+    sort(files.begin(), files.end());
+
+    vector<vector<char>> contents;
+    vector<string> names;
+    size_t indexSize = 0;
+
+    for (const filesystem::path& path : files)
+    {
+        ifstream input(path, ios::binary);
+
+        if (!input)
+        {
+            return false;
+        }
+        contents.emplace_back(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+
+        names.push_back(assets_dir + filesystem::relative(path, directory).generic_string());
+        indexSize += 4 + names.back().size() + 16;
+    }
+
+    vector<unsigned char> header(ARCHIVE_MAGIC, ARCHIVE_MAGIC + 4);
+    Write32(header, ARCHIVE_VERSION);
+    Write32(header, static_cast<uint32_t>(files.size()));
+
+    size_t offset = ARCHIVE_HEADER_SIZE + indexSize;
+    vector<size_t> offsets;
+
+    for (size_t index = 0; index < files.size(); index++)
+    {
+        offset = (offset + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+        offsets.push_back(offset);
+
+        const unsigned long long hash = XxHash64(contents[index].data(), contents[index].size());
+        Write32(header, static_cast<uint32_t>(names[index].size()));
+        header.insert(header.end(), names[index].begin(), names[index].end());
+        Write32(header, static_cast<uint32_t>(offset));
+        Write32(header, static_cast<uint32_t>(contents[index].size()));
+        Write32(header, static_cast<uint32_t>(hash));
+        Write32(header, static_cast<uint32_t>(hash >> 32));
+
+        offset += contents[index].size();
+    }
+
+    if (offset > UINT32_MAX)
+    {
+        return false;
+    }
+
+    ofstream output(fileName, ios::binary);
+    output.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+    for (size_t index = 0; index < files.size(); index++)
+    {
+        const vector<char> padding(offsets[index] - static_cast<size_t>(output.tellp()), 0);
+        output.write(padding.data(), padding.size());
+        output.write(contents[index].data(), contents[index].size());
+    }
+
+    return static_cast<bool>(output);
+}
+
+string GetExecutableDirectory()
+{
+#if defined(_WIN32)
+    char path[MAX_PATH];
+    const DWORD length = GetModuleFileNameA(nullptr, path, MAX_PATH);
+
+    if (length == 0 || length == MAX_PATH)
+    {
+        return "";
+    }
+    return filesystem::path(string(path, length)).parent_path().string() + "\\";
+#else
+    error_code error;
+    const filesystem::path path = filesystem::read_symlink("/proc/self/exe", error);
+
+    if (error)
+    {
+        return "";
+    }
+    return path.parent_path().string() + "/";
+#endif
+}
+
+// --pack-assets [archive] [assets directory]
+int RunPackAssets(int argc, char* argv[])
+{
+    const string fileName = argc > 2 ? argv[2] : GetExecutableDirectory() + ASSET_ARCHIVE;
+    const string directory = argc > 3 ? argv[3] : assets_dir;
+
+    if (!Archive::Pack(directory, fileName))
+    {
+        cout << "Cannot pack " << directory << " into " << fileName << '\n';
+        return 1;
+    }
+
+    // Read it back like the game does
+    Archive archive;
+
+    if (!archive.Open(fileName))
+    {
+        cout << "Cannot open " << fileName << '\n';
+        return 1;
+    }
+
+    cout << "Packed " << archive.GetEntryCount() << " files into " << fileName << " (" << filesystem::file_size(fileName) << " bytes)\n";
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "assetloader.h"
+
+#include "trace.h"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+AssetLoader::AssetLoader(unsigned int threads) : start(chrono::steady_clock::now())
+{
+    if (threads == 0)
+    {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+
+    for (unsigned int index = 0; index < threads; index++)
+    {
+        workers.emplace_back(&AssetLoader::Work, this);
+    }
+}
+
+// Waits for the assets still loading
+AssetLoader::~AssetLoader()
+{
+    {
+        lock_guard<mutex> lock(jobsMutex);
+        stop = true;
+    }
+    wakeCondition.notify_all();
+
+    for (thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+future<bool> AssetLoader::Load(const char* name, function<bool()> load)
+{
+    future<bool> result;
+
+    {
+        lock_guard<mutex> lock(jobsMutex);
+        Job& job = jobs.emplace_back();
+        job.name = name;
+        job.load = move(load);
+        result = job.result.get_future();
+        assetCount++;
+    }
+    wakeCondition.notify_one();
+
+    return result;
+}
+
+size_t AssetLoader::GetAssetCount() const
+{
+    lock_guard<mutex> lock(jobsMutex);
+    return assetCount;
+}
+
+size_t AssetLoader::GetLoadedCount() const
+{
+    lock_guard<mutex> lock(jobsMutex);
+    return timings.size();
+}
+
+bool AssetLoader::IsDone() const
+{
+    lock_guard<mutex> lock(jobsMutex);
+    return timings.size() == assetCount;
+}
+
+vector<AssetLoader::Timing> AssetLoader::GetTimings() const
+{
+    lock_guard<mutex> lock(jobsMutex);
+    return timings;
+}
+
+void AssetLoader::Work()
+{
+    Trace::SetThreadName("Asset loader");
+    unique_lock<mutex> lock(jobsMutex);
+
+    while (true)
+    {
+        // The remaining jobs are still run when the loader is destroyed, so no future is left without value
+        wakeCondition.wait(lock, [this] { return stop || !jobs.empty(); });
+
+        if (jobs.empty())
+        {
+            return;
+        }
+
+        Job job = move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+
+        const chrono::steady_clock::time_point jobStart = chrono::steady_clock::now();
+        bool loaded = false;
+
+        // An exception (corrupt file, out of memory) fails this asset instead of terminating the program
+        try
+        {
+            loaded = job.load();
+        }
+        catch (const exception& error)
+        {
+            cerr << "Error loading " << job.name << ": " << error.what() << "\n";
+        }
+        catch (...)
+        {
+            cerr << "Error loading " << job.name << "\n";
+        }
+
+        const chrono::steady_clock::time_point jobEnd = chrono::steady_clock::now();
+        Trace::Complete(job.name, jobStart, jobEnd);
+
+        // Set before the timing so every future is ready once IsDone() is true
+        job.result.set_value(loaded);
+
+        lock.lock();
+        timings.push_back({ job.name, chrono::duration<double, milli>(jobStart - start).count(),
+            chrono::duration<double, milli>(jobEnd - start).count(), loaded });
+    }
+}
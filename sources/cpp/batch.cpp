@@ -0,0 +1,268 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "batch.h"
+
+#include "ai.h"
+#include "histogram.h"
+#include "policy.h"
+#include "searchai.h"
+#include "simulation.h"
+#include "vecenv.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+int RunBatch(unsigned int matches, bool search, const string& histogramFile)
+{
+    ThreadPool pool;
+    SearchAI::Stats searchStats{};
+    Histogram tickHistogram;
+    const bool measureTicks = !histogramFile.empty();
+
+    unsigned int winsL = 0;
+    unsigned int winsR = 0;
+    unsigned long long frames = 0;
+    unsigned long long hits = 0;
+
+    const auto start = chrono::steady_clock::now();
+
+    for (unsigned int match = 0; match < matches; match++)
+    {
+        Simulation simulation;
+        AI cpuL(PlayerLeft, CPU_REACTION_DELAY, CPU_AIM_ERROR, match * 2);
+        AI cpuR(PlayerRight, CPU_REACTION_DELAY, CPU_AIM_ERROR, match * 2 + 1);
+        SearchAI searchL(PlayerLeft, pool, SEARCH_BUDGET_MS, match * 2);
+        Collision collision = None;
+
+        while (!simulation.GetState().win)
+        {
+            const Simulation::State& state = simulation.GetState();
+            Input::Button button{};
+
+            cpuR.Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
+            cpuR.Control(button, state.racketRY);
+
+            if (search)
+            {
+                searchL.Observe(collision, state);
+                searchL.Control(button, state);
+            }
+            else
+            {
+                cpuL.Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
+                cpuL.Control(button, state.racketLY);
+            }
+
+            if (measureTicks)
+            {
+                const auto tickStart = chrono::steady_clock::now();
+                collision = simulation.Step(button);
+                tickHistogram.Record(chrono::duration<double, micro>(chrono::steady_clock::now() - tickStart).count());
+            }
+            else
+            {
+                collision = simulation.Step(button);
+            }
+            frames++;
+
+            if (collision == TopRacketL || collision == BottomRacketL || collision == TopRacketR || collision == BottomRacketR)
+            {
+                hits++;
+            }
+        }
+
+        searchStats.decisions += searchL.GetStats().decisions;
+        searchStats.rollouts += searchL.GetStats().rollouts;
+        searchStats.frames += searchL.GetStats().frames;
+        searchStats.overBudget += searchL.GetStats().overBudget;
+        searchStats.fallbacks += searchL.GetStats().fallbacks;
+        searchStats.seconds += searchL.GetStats().seconds;
+
+        if (simulation.GetState().scoreL > simulation.GetState().scoreR)
+        {
+            winsL++;
+        }
+        else
+        {
+            winsR++;
+        }
+    }
+
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Matches: " << matches << " (left " << winsL << ", right " << winsR << ")\n";
+    cout << "Frames: " << frames << ", racket hits: " << hits << "\n";
+    cout << "Time: " << seconds << " s (" << matches / seconds << " matches/s, " << frames / seconds << " frames/s)\n";
+
+    if (search)
+    {
+        cout << "Search: " << searchStats.decisions << " decisions on " << pool.GetThreadCount() << " threads, "
+            << static_cast<double>(searchStats.rollouts) / searchStats.decisions << " rollouts and "
+            << searchStats.seconds * 1000.0 / searchStats.decisions << " ms per decision, "
+            << searchStats.frames / searchStats.seconds << " simulated frames/s\n";
+        cout << "Over budget: " << searchStats.overBudget << ", fallbacks: " << searchStats.fallbacks << "\n";
+    }
+
+    if (measureTicks)
+    {
+        tickHistogram.Report("Tick", cout);
+
+        if (!tickHistogram.SaveToFile(histogramFile))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int RunVecEnv(unsigned int envs, unsigned int steps, unsigned int threads)
+{
+    VecEnv env(envs, threads);
+
+    vector<float> observations(envs * VecEnv::OBSERVATION_SIZE);
+    vector<float> rewards(envs * VecEnv::REWARD_SIZE);
+    vector<unsigned char> dones(envs);
+
+    // A few random action sets, drawn before the measure
+    const unsigned int actionSets = 16;
+    vector<unsigned char> actions(actionSets * envs * VecEnv::ACTION_SIZE);
+    mt19937 random(0);
+    uniform_int_distribution<int> action(VecEnv::ActionNone, VecEnv::ActionDown);
+
+    for (unsigned char& value : actions)
+    {
+        value = static_cast<unsigned char>(action(random));
+    }
+
+    env.Reset(observations.data());
+
+    unsigned long long episodes = 0;
+    const auto start = chrono::steady_clock::now();
+
+    for (unsigned int step = 0; step < steps; step++)
+    {
+        const unsigned char* stepActions = actions.data() + (step % actionSets) * envs * VecEnv::ACTION_SIZE;
+        env.Step(stepActions, observations.data(), rewards.data(), dones.data());
+
+        for (unsigned char done : dones)
+        {
+            episodes += done;
+        }
+    }
+
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    const double envSteps = static_cast<double>(envs) * steps;
+
+    cout << "Envs: " << envs << ", threads: " << env.GetThreadCount() << ", steps: " << steps << ", episodes: " << episodes << "\n";
+    cout << "Time: " << seconds << " s (" << envSteps / seconds << " env-steps/s)\n";
+
+    return 0;
+}
+
+int RunPolicy(const string& fileName, unsigned int matches, unsigned int steps)
+{
+    Policy policy;
+
+    if (!policy.LoadFromFile(fileName))
+    {
+        return 1;
+    }
+
+    VecEnv env(matches);
+
+    // One decision for each racket of each match
+    vector<float> observations(matches * VecEnv::OBSERVATION_SIZE);
+    vector<float> policyObservations(matches * 2 * VecEnv::OBSERVATION_SIZE);
+    vector<unsigned char> actions(matches * VecEnv::ACTION_SIZE);
+    vector<float> rewards(matches * VecEnv::REWARD_SIZE);
+    vector<unsigned char> dones(matches);
+
+    env.Reset(observations.data());
+
+    unsigned long long finished = 0;
+    unsigned int winsL = 0;
+    double policySeconds = 0.0;
+    const auto start = chrono::steady_clock::now();
+
+    for (unsigned int step = 0; step < steps; step++)
+    {
+        for (unsigned int match = 0; match < matches; match++)
+        {
+            Policy::Observe(env.GetState(match), PlayerLeft, &policyObservations[(match * 2) * VecEnv::OBSERVATION_SIZE]);
+            Policy::Observe(env.GetState(match), PlayerRight, &policyObservations[(match * 2 + 1) * VecEnv::OBSERVATION_SIZE]);
+        }
+
+        const auto policyStart = chrono::steady_clock::now();
+        policy.Act(policyObservations.data(), actions.data(), matches * 2);
+        policySeconds += chrono::duration<double>(chrono::steady_clock::now() - policyStart).count();
+
+        env.Step(actions.data(), observations.data(), rewards.data(), dones.data());
+
+        for (unsigned int match = 0; match < matches; match++)
+        {
+            if (dones[match])
+            {
+                finished++;
+                // The last point was scored by the winner
+                winsL += rewards[match * VecEnv::REWARD_SIZE] > 0.f ? 1 : 0;
+            }
+        }
+    }
+
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    const double decisions = static_cast<double>(matches) * 2 * steps;
+
+    cout << "Matches: " << matches << ", steps: " << steps << ", finished: " << finished << " (left " << winsL << ", right " << finished - winsL << ")\n";
+    cout << "Time: " << seconds << " s, policy: " << policySeconds * 1e9 / decisions << " ns per decision\n";
+
+    return 0;
+}
+
+int RunHistogramMerge(int argc, char* argv[])
+{
+    Histogram merged;
+
+    for (int index = 2; index < argc; index++)
+    {
+        Histogram histogram;
+
+        if (!histogram.LoadFromFile(argv[index]))
+        {
+            return 1;
+        }
+
+        histogram.Report(argv[index], cout);
+        merged.Merge(histogram);
+    }
+
+    merged.Report("Merged", cout);
+
+    return 0;
+}
@@ -0,0 +1,917 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "bench.h"
+
+#include "ai.h"
+#include "archive.h"
+#include "ball.h"
+#include "codec.h"
+#include "hudtext.h"
+#include "input.h"
+#include "particles.h"
+#include "protocol.h"
+#include "racket.h"
+#include "settings.h"
+#include "simulation.h"
+#include "synth.h"
+#include "utils.h"
+#include "voicepool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Minimum duration of one repetition, the number of iterations is doubled until it is reached
+const double BENCHMARK_MIN_SECONDS{ 0.02 };
+const unsigned int BENCHMARK_DEFAULT_REPETITIONS{ 10 };
+// Limit of the warmup, a benchmark that reaches it is failed
+const unsigned long long BENCHMARK_MAX_ITERATIONS{ 1ULL << 40 };
+
+// Baseline comparison properties
+const string BENCHMARK_BASELINE_DIR{ "benchmarks/" };
+const unsigned int BENCHMARK_DEFAULT_RUNS{ 3 };
+// A difference is significant if the probability that it comes from noise is lower than this value...
+const double BENCHMARK_ALPHA{ 0.01 };
+// ...and if the medians differ by more than this percentage
+const double BENCHMARK_DEFAULT_THRESHOLD{ 5.0 };
+
+// Written by the benchmarks so the compiler can't remove the measured code
+volatile double benchmarkSink = 0.0;
+
+struct Benchmark
+{
+    string name;
+    // Run the operation the given number of times
+    function<void(unsigned long long)> run;
+    // Loads what the benchmark needs, the benchmark fails if it returns false (optional)
+    function<bool()> prepare = nullptr;
+};
+
+static double Measure(const Benchmark& benchmark, unsigned long long iterations)
+{
+    const auto start = chrono::steady_clock::now();
+    benchmark.run(iterations);
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Load the font of the game like main() does: from the archive next to the executable, or the loose file
+static bool LoadBenchmarkFont(Font& font, Archive& archive)
+{
+    if (!archive.Open(GetExecutableDirectory() + ASSET_ARCHIVE))
+    {
+        archive.Open(ASSET_ARCHIVE);
+    }
+
+    return LoadFont(font, archive, font_file);
+}
+
+// Null if the font can't be loaded
+static const Font* GetBenchmarkFont()
+{
+    // Kept open while the font is used
+    static Archive archive;
+    static Font font;
+    static const bool loaded = LoadBenchmarkFont(font, archive);
+
+    return loaded ? &font : nullptr;
+}
+
+static bool HasBenchmarkFont()
+{
+    return GetBenchmarkFont() != nullptr;
+}
+
+// A match state where Intersect() returns the given collision
+static Simulation::State CollisionState(Collision collision)
+{
+    Simulation simulation;
+    Simulation::State state = simulation.GetState();
+    const float racketLFace = static_cast<float>(DEFAULT_RACKET_L_POS_X + RACKET_L_WIDTH);
+    const float racketRFace = DEFAULT_RACKET_R_POS_X - BALL_RADIUS * 2;
+
+    switch (collision)
+    {
+    case TopRacketL:
+        state.ballPosition = Vector2f(racketLFace, state.racketLY);
+        break;
+    case BottomRacketL:
+        state.ballPosition = Vector2f(racketLFace, state.racketLY + RACKET_L_HEIGHT - BALL_RADIUS);
+        break;
+    case TopRacketR:
+        state.ballPosition = Vector2f(racketRFace, state.racketRY);
+        break;
+    case BottomRacketR:
+        state.ballPosition = Vector2f(racketRFace, state.racketRY + RACKET_R_HEIGHT - BALL_RADIUS);
+        break;
+    case TopWindow:
+        state.ballPosition.y = 0.f;
+        break;
+    case BottomWindow:
+        state.ballPosition.y = WINDOW_HEIGHT - BALL_RADIUS * 2;
+        break;
+    case LeftWindow:
+        state.ballPosition = Vector2f(0.f, 10.f);
+        break;
+    case RightWindow:
+        state.ballPosition = Vector2f(WINDOW_WIDTH - BALL_RADIUS * 2, 10.f);
+        break;
+    default:
+        break;
+    }
+
+    return state;
+}
+
+static const char* GetCollisionName(Collision collision)
+{
+    switch (collision)
+    {
+    case TopRacketL:
+        return "TopRacketL";
+    case BottomRacketL:
+        return "BottomRacketL";
+    case TopRacketR:
+        return "TopRacketR";
+    case BottomRacketR:
+        return "BottomRacketR";
+    case TopWindow:
+        return "TopWindow";
+    case BottomWindow:
+        return "BottomWindow";
+    case LeftWindow:
+        return "LeftWindow";
+    case RightWindow:
+        return "RightWindow";
+    default:
+        return "None";
+    }
+}
+
+static vector<Benchmark> CreateBenchmarks()
+{
+    vector<Benchmark> benchmarks;
+
+    // Collision detection, for each result of Intersect() (RacketL and RacketR are never returned)
+    const Collision collisions[] = { TopRacketL, BottomRacketL, TopRacketR, BottomRacketR, TopWindow, BottomWindow, LeftWindow, RightWindow, None };
+
+    for (Collision collision : collisions)
+    {
+        benchmarks.push_back({ string("Intersect/") + GetCollisionName(collision), [collision](unsigned long long iterations)
+        {
+            Simulation simulation;
+            simulation.SetState(CollisionState(collision));
+
+            if (simulation.Intersect() != collision)
+            {
+                cerr << "Wrong benchmark state for " << GetCollisionName(collision) << "\n";
+            }
+
+            unsigned long long count = 0;
+            for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+            {
+                count += simulation.Intersect();
+            }
+            benchmarkSink = benchmarkSink + static_cast<double>(count);
+        } });
+    }
+
+    // Movement of the shapes
+    benchmarks.push_back({ "Ball::Move", [](unsigned long long iterations)
+    {
+        Ball ball(BALL_RADIUS, DEFAULT_BALL_POS_X, DEFAULT_BALL_POS_Y, BALL_COLOR);
+        Vector2f direction(1.f, 0.5f);
+
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            ball.Move(direction, DEFAULT_BALL_SPEED);
+            direction = -direction;
+        }
+        benchmarkSink = benchmarkSink + ball.GetPosition().x;
+    } });
+
+    benchmarks.push_back({ "Racket::Move", [](unsigned long long iterations)
+    {
+        Racket racket(RACKET_L_WIDTH, RACKET_L_HEIGHT, DEFAULT_RACKET_L_POS_X, DEFAULT_RACKET_L_POS_Y, PLAYER_L_COLOR);
+        int direction = 1;
+
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            racket.Move(direction, RACKET_L_SPEED);
+            direction = -direction;
+        }
+        benchmarkSink = benchmarkSink + racket.GetPosition().y;
+    } });
+
+    // Keyboard events, alternately pressed and released
+    benchmarks.push_back({ "Input::InputHandler", [](unsigned long long iterations)
+    {
+        // Not opened: InputHandler only needs it for the Closed event
+        RenderWindow window;
+        Input input;
+        const Keyboard::Key keys[] = { Keyboard::Z, Keyboard::S, Keyboard::Up, Keyboard::Down, Keyboard::Escape, Keyboard::Space, Keyboard::A };
+        Event event;
+
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            event.type = iteration % 2 == 0 ? Event::KeyPressed : Event::KeyReleased;
+            event.key.code = keys[(iteration / 2) % 7];
+            input.InputHandler(event, window);
+        }
+        benchmarkSink = benchmarkSink + input.GetButton().up;
+    } });
+
+    // Score text layout, like UpdateScore()
+    benchmarks.push_back({ "SetText+getLocalBounds", [](unsigned long long iterations)
+    {
+        Text text("0", *GetBenchmarkFont(), SCORE_FONT_SIZE);
+        const String scores[] = { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "10" };
+        float width = 0.f;
+
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            SetText(text, scores[iteration % 11]);
+            width += text.getLocalBounds().width;
+        }
+        benchmarkSink = benchmarkSink + width;
+    }, HasBenchmarkFont });
+
+    // Collision sound triggers, without rate limiting so every voice is busy and stolen
+    benchmarks.push_back({ "VoicePool::Play", [](unsigned long long iterations)
+    {
+        static SoundBuffer buffer;
+        static bool loaded = Synth::Generate(RACKET_SOUND_PATCH, SYNTH_SAMPLE_RATE, buffer);
+
+        if (!loaded)
+        {
+            return;
+        }
+
+        static VoicePool voicePool(SOUND_VOICES);
+        static const unsigned int racketSound = voicePool.AddEffect(buffer, 0.f, RACKET_SOUND_PRIORITY, 0.f);
+        static const unsigned int wallSound = voicePool.AddEffect(buffer, 0.f, WALL_SOUND_PRIORITY, 0.f);
+        unsigned long long played = 0;
+
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            played += voicePool.Play(iteration % 4 == 0 ? racketSound : wallSound, static_cast<float>(iteration % WINDOW_WIDTH));
+        }
+        voicePool.StopAll();
+        benchmarkSink = benchmarkSink + static_cast<double>(played);
+    } });
+
+    // Samples of every sound effect, like at startup
+    benchmarks.push_back({ "Synth::Generate (all effects)", [](unsigned long long iterations)
+    {
+        vector<Int16> samples;
+        size_t count = 0;
+
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            Synth::Generate(RACKET_SOUND_PATCH, SYNTH_SAMPLE_RATE, samples);
+            count += samples.size();
+            Synth::Generate(WALL_SOUND_PATCH, SYNTH_SAMPLE_RATE, samples);
+            count += samples.size();
+        }
+        benchmarkSink = benchmarkSink + static_cast<double>(count);
+    } });
+
+    // Same layout from the glyph atlas, with the quads of the text
+    benchmarks.push_back({ "HudText::SetString+Append", [](unsigned long long iterations)
+    {
+        static GlyphAtlas atlas;
+
+        if (atlas.GetGlyphCount() == 0)
+        {
+            atlas.Add(SCORE_FONT_SIZE, "0123456789");
+            atlas.Build(*GetBenchmarkFont());
+        }
+
+        HudText text("0", atlas, SCORE_FONT_SIZE);
+        VertexArray vertices(Quads);
+        const String scores[] = { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "10" };
+        float width = 0.f;
+
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            text.SetString(scores[iteration % 11]);
+            width += text.GetLocalBounds().width;
+            vertices.clear();
+            text.Append(vertices);
+        }
+        benchmarkSink = benchmarkSink + width + static_cast<float>(vertices.getVertexCount());
+    }, HasBenchmarkFont });
+
+    // One frame of 100k live particles, the dead ones are replaced like a continuous stream of hits
+    const auto particleFrame = [](ParticleSystem& particles)
+    {
+        particles.Emit(Vector2f(WINDOW_WIDTH / 2.f, WINDOW_HEIGHT / 2.f), Color::White, static_cast<unsigned int>(particles.GetCapacity() - particles.GetCount()), 0.f, 6.2831853f);
+        particles.Update(1.f / 60.f);
+    };
+
+    benchmarks.push_back({ "ParticleSystem::Update (100k)", [particleFrame](unsigned long long iterations)
+    {
+        static ParticleSystem particles(100000);
+
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            particleFrame(particles);
+        }
+        benchmarkSink = benchmarkSink + static_cast<double>(particles.GetCount());
+    } });
+
+    benchmarks.push_back({ "ParticleSystem::BuildVertices (100k)", [particleFrame](unsigned long long iterations)
+    {
+        static ParticleSystem particles(100000);
+        particleFrame(particles);
+
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            particles.BuildVertices();
+        }
+        benchmarkSink = benchmarkSink + static_cast<double>(particles.GetCount());
+    } });
+
+    // Complete frames of a headless match between two predictive AIs
+    benchmarks.push_back({ "Simulation::Step (AI vs AI)", [](unsigned long long iterations)
+    {
+        Simulation simulation;
+        AI cpuL(PlayerLeft, CPU_REACTION_DELAY, CPU_AIM_ERROR, 1);
+        AI cpuR(PlayerRight, CPU_REACTION_DELAY, CPU_AIM_ERROR, 2);
+        Collision collision = None;
+
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            const Simulation::State& state = simulation.GetState();
+            Input::Button button{};
+
+            cpuL.Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
+            cpuR.Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
+            cpuL.Control(button, state.racketLY);
+            cpuR.Control(button, state.racketRY);
+
+            collision = simulation.Step(button);
+
+            if (simulation.GetState().win)
+            {
+                simulation.Reset();
+            }
+        }
+        benchmarkSink = benchmarkSink + simulation.GetState().ballPosition.x;
+    } });
+
+    // Network codec, on the states of a match so the deltas are realistic
+    const auto recordStates = []()
+    {
+        vector<Simulation::State> states;
+        Simulation simulation;
+        AI cpuL(PlayerLeft, CPU_REACTION_DELAY, CPU_AIM_ERROR, 1);
+        AI cpuR(PlayerRight, CPU_REACTION_DELAY, CPU_AIM_ERROR, 2);
+        Collision collision = None;
+
+        while (states.size() < 1024)
+        {
+            const Simulation::State& state = simulation.GetState();
+            Input::Button button{};
+            cpuL.Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
+            cpuR.Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
+            cpuL.Control(button, state.racketLY);
+            cpuR.Control(button, state.racketRY);
+            collision = simulation.Step(button);
+            states.push_back(simulation.GetState());
+        }
+
+        return states;
+    };
+
+    benchmarks.push_back({ "Codec::WriteState", [recordStates](unsigned long long iterations)
+    {
+        static const vector<Simulation::State> states = recordStates();
+        unsigned char packet[MAX_PACKET_SIZE];
+        size_t size = 0;
+
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            size += WriteState(packet, static_cast<uint32_t>(iteration), states[iteration % states.size()]);
+        }
+        benchmarkSink = benchmarkSink + static_cast<double>(size + packet[0]);
+    } });
+
+    benchmarks.push_back({ "Codec::ReadState", [recordStates](unsigned long long iterations)
+    {
+        static const vector<Simulation::State> states = recordStates();
+        unsigned char packets[64][MAX_PACKET_SIZE];
+        size_t sizes[64];
+        for (size_t index = 0; index < 64; index++)
+        {
+            sizes[index] = WriteState(packets[index], static_cast<uint32_t>(index), states[index * 16]);
+        }
+
+        Simulation::State state{};
+        uint32_t tick;
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            ReadState(packets[iteration % 64], sizes[iteration % 64], tick, state);
+        }
+        benchmarkSink = benchmarkSink + state.ballPosition.x;
+    } });
+
+    benchmarks.push_back({ "Codec::WriteDelta", [recordStates](unsigned long long iterations)
+    {
+        static const vector<Simulation::State> states = recordStates();
+        unsigned char frame[MAX_FRAME_SIZE];
+        size_t size = 0;
+
+        for (unsigned long long iteration = 0; iteration < iterations; iteration++)
+        {
+            const size_t index = iteration % (states.size() - 1);
+            size += WriteDelta(frame, static_cast<uint32_t>(iteration), states[index], states[index + 1]);
+        }
+        benchmarkSink = benchmarkSink + static_cast<double>(size + frame[0]);
+    } });
+
+    return benchmarks;
+}
+
+// Statistics of the samples
+static void Summarize(BenchmarkResult& result)
+{
+    double sum = 0.0;
+    for (double sample : result.samples)
+    {
+        sum += sample;
+    }
+    result.mean = sum / result.samples.size();
+
+    double variance = 0.0;
+    for (double sample : result.samples)
+    {
+        variance += (sample - result.mean) * (sample - result.mean);
+    }
+    result.stddev = result.samples.size() > 1 ? sqrt(variance / (result.samples.size() - 1)) : 0.0;
+    result.min = *min_element(result.samples.begin(), result.samples.end());
+    result.max = *max_element(result.samples.begin(), result.samples.end());
+}
+
+vector<BenchmarkResult> RunBenchmarks(const string& filter, unsigned int repetitions, vector<string>& failed)
+{
+    vector<BenchmarkResult> results;
+
+    for (const Benchmark& benchmark : CreateBenchmarks())
+    {
+        if (benchmark.name.find(filter) == string::npos)
+        {
+            continue;
+        }
+
+        if (benchmark.prepare && !benchmark.prepare())
+        {
+            cerr << "Benchmark " << benchmark.name << " failed: its assets could not be loaded\n";
+            failed.push_back(benchmark.name);
+            continue;
+        }
+
+        // Warmup, also finds the number of iterations of a repetition
+        unsigned long long iterations = 1;
+        while (Measure(benchmark, iterations) < BENCHMARK_MIN_SECONDS)
+        {
+            // No operation takes less than a picosecond, the benchmark returned without doing anything
+            if (iterations >= BENCHMARK_MAX_ITERATIONS)
+            {
+                break;
+            }
+            iterations *= 2;
+        }
+
+        if (iterations >= BENCHMARK_MAX_ITERATIONS)
+        {
+            cerr << "Benchmark " << benchmark.name << " failed: it doesn't run the operation\n";
+            failed.push_back(benchmark.name);
+            continue;
+        }
+
+        BenchmarkResult result;
+        result.name = benchmark.name;
+        result.iterations = iterations;
+
+        for (unsigned int repetition = 0; repetition < repetitions; repetition++)
+        {
+            result.samples.push_back(Measure(benchmark, iterations) * 1e9 / static_cast<double>(iterations));
+        }
+
+        Summarize(result);
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+bool SaveBenchmarks(const vector<BenchmarkResult>& results, const string& fileName)
+{
+    ofstream file(fileName);
+
+    if (!file)
+    {
+        cerr << "Error writing benchmark file: " << fileName << "\n";
+        return false;
+    }
+
+    char date[32];
+    const time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    file << "{\n  \"date\": \"" << date << "\",\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [\n";
+    file.precision(6);
+
+    for (size_t index = 0; index < results.size(); index++)
+    {
+        const BenchmarkResult& result = results[index];
+
+        file << "    {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+            << ", \"mean\": " << result.mean << ", \"stddev\": " << result.stddev
+            << ", \"min\": " << result.min << ", \"max\": " << result.max << ", \"samples\": [";
+
+        for (size_t sample = 0; sample < result.samples.size(); sample++)
+        {
+            file << (sample > 0 ? ", " : "") << result.samples[sample];
+        }
+
+        file << "]}" << (index + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    file << "  ]\n}\n";
+
+    return true;
+}
+
+bool LoadBenchmarks(vector<BenchmarkResult>& results, const string& fileName)
+{
+    ifstream file(fileName);
+
+    if (!file)
+    {
+        cerr << "Error opening benchmark file: " << fileName << "\n";
+        return false;
+    }
+
+    stringstream content;
+    content << file.rdbuf();
+    const string text = content.str();
+
+    results.clear();
+    size_t position = 0;
+
+    while ((position = text.find("\"name\": \"", position)) != string::npos)
+    {
+        position += 9;
+        const size_t nameEnd = text.find('"', position);
+        const size_t samplesStart = text.find("\"samples\": [", nameEnd);
+        const size_t samplesEnd = text.find(']', samplesStart);
+
+        if (nameEnd == string::npos || samplesStart == string::npos || samplesEnd == string::npos)
+        {
+            cerr << "Error reading benchmark file: " << fileName << "\n";
+            return false;
+        }
+
+        BenchmarkResult result;
+        result.name = text.substr(position, nameEnd - position);
+        result.iterations = 0;
+
+        stringstream samples(text.substr(samplesStart + 12, samplesEnd - samplesStart - 12));
+        string sample;
+
+        while (getline(samples, sample, ','))
+        {
+            char* end = nullptr;
+            const double value = strtod(sample.c_str(), &end);
+
+            if (end == sample.c_str() || !isfinite(value) || value < 0.0)
+            {
+                cerr << "Error reading benchmark file: " << fileName << " (sample of " << result.name << ")\n";
+                return false;
+            }
+            result.samples.push_back(value);
+        }
+
+        if (result.samples.empty())
+        {
+            cerr << "Error reading benchmark file: " << fileName << " (no sample for " << result.name << ")\n";
+            return false;
+        }
+
+        Summarize(result);
+        results.push_back(result);
+
+        position = samplesEnd;
+    }
+
+    if (results.empty())
+    {
+        cerr << "Error reading benchmark file: " << fileName << " (no benchmark)\n";
+        return false;
+    }
+
+    return true;
+}
+
+void PrintBenchmarks(const vector<BenchmarkResult>& results)
+{
+    char line[160];
+
+    snprintf(line, sizeof(line), "%-36s %12s %10s %12s %12s %12s", "Benchmark", "ns/op", "stddev %", "min", "max", "iterations");
+    cout << line << "\n";
+
+    for (const BenchmarkResult& result : results)
+    {
+        snprintf(line, sizeof(line), "%-36s %12.2f %10.2f %12.2f %12.2f %12llu", result.name.c_str(), result.mean,
+            result.mean > 0.0 ? result.stddev / result.mean * 100.0 : 0.0, result.min, result.max, result.iterations);
+        cout << line << "\n";
+    }
+}
+
+int RunBench(int argc, char* argv[])
+{
+    string filter;
+    string jsonFile;
+    unsigned int repetitions = BENCHMARK_DEFAULT_REPETITIONS;
+
+    for (int index = 2; index + 1 < argc; index += 2)
+    {
+        const string option = argv[index];
+
+        if (option == "--filter")
+        {
+            filter = argv[index + 1];
+        }
+        else if (option == "--repetitions")
+        {
+            repetitions = max(1u, static_cast<unsigned int>(stoul(argv[index + 1])));
+        }
+        else if (option == "--json")
+        {
+            jsonFile = argv[index + 1];
+        }
+    }
+
+    vector<string> failed;
+    const vector<BenchmarkResult> results = RunBenchmarks(filter, repetitions, failed);
+    PrintBenchmarks(results);
+
+    if (!jsonFile.empty() && !SaveBenchmarks(results, jsonFile))
+    {
+        return 1;
+    }
+
+    return failed.empty() ? 0 : 1;
+}
+
+static double Median(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+    const size_t middle = samples.size() / 2;
+
+    return samples.size() % 2 == 1 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2.0;
+}
+
+// Two-sided p-value of the Mann-Whitney U test (normal approximation with tie correction):
+// probability that the two sets of samples come from the same distribution
+static double MannWhitney(const vector<double>& first, const vector<double>& second)
+{
+    const double n1 = static_cast<double>(first.size());
+    const double n2 = static_cast<double>(second.size());
+    const double n = n1 + n2;
+
+    vector<pair<double, int>> values;
+    for (double sample : first)
+    {
+        values.push_back(make_pair(sample, 0));
+    }
+    for (double sample : second)
+    {
+        values.push_back(make_pair(sample, 1));
+    }
+    sort(values.begin(), values.end());
+
+    // Sum of the ranks of the first set, ties get their average rank
+    double rankSum = 0.0;
+    double ties = 0.0;
+
+    for (size_t begin = 0; begin < values.size();)
+    {
+        size_t end = begin;
+        while (end < values.size() && values[end].first == values[begin].first)
+        {
+            end++;
+        }
+
+        const double rank = (begin + 1 + end) / 2.0;
+        const double count = static_cast<double>(end - begin);
+
+        for (size_t index = begin; index < end; index++)
+        {
+            if (values[index].second == 0)
+            {
+                rankSum += rank;
+            }
+        }
+
+        ties += count * count * count - count;
+        begin = end;
+    }
+
+    const double u = rankSum - n1 * (n1 + 1) / 2.0;
+    const double mean = n1 * n2 / 2.0;
+    const double deviation = sqrt(n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1))));
+
+    if (deviation == 0.0)
+    {
+        return 1.0;
+    }
+
+    // Continuity correction
+    const double z = (fabs(u - mean) - 0.5) / deviation;
+
+    return min(1.0, erfc(max(z, 0.0) / sqrt(2.0)));
+}
+
+// Name of the machine, used when no profile is given
+static string GetMachineProfile()
+{
+    if (const char* name = getenv("COMPUTERNAME"))
+    {
+        return name;
+    }
+
+    ifstream file("/proc/sys/kernel/hostname");
+    string name;
+
+    if (getline(file, name) && !name.empty())
+    {
+        return name;
+    }
+
+    return "default";
+}
+
+int RunBenchCompare(int argc, char* argv[])
+{
+    string profile = GetMachineProfile();
+    string filter;
+    unsigned int runs = BENCHMARK_DEFAULT_RUNS;
+    double threshold = BENCHMARK_DEFAULT_THRESHOLD;
+    bool update = false;
+
+    for (int index = 2; index < argc; index++)
+    {
+        const string option = argv[index];
+
+        if (option == "--update")
+        {
+            update = true;
+        }
+        else if (index + 1 < argc)
+        {
+            if (option == "--profile")
+            {
+                profile = argv[++index];
+            }
+            else if (option == "--runs")
+            {
+                runs = max(1u, static_cast<unsigned int>(stoul(argv[++index])));
+            }
+            else if (option == "--filter")
+            {
+                filter = argv[++index];
+            }
+            else if (option == "--threshold")
+            {
+                threshold = stod(argv[++index]);
+            }
+        }
+    }
+
+    const string baselineFile = BENCHMARK_BASELINE_DIR + profile + ".json";
+    vector<BenchmarkResult> baseline;
+
+    // Only the first run of the machine saves the baseline, a baseline that can't be read is not replaced
+    const bool saveBaseline = update || !filesystem::exists(baselineFile);
+
+    if (!saveBaseline && !LoadBenchmarks(baseline, baselineFile))
+    {
+        cerr << "Invalid baseline, run with --update to replace it\n";
+        return 1;
+    }
+
+    // Several runs of the whole suite, so that a slow period of the machine doesn't hit a single benchmark
+    vector<BenchmarkResult> current;
+
+    for (unsigned int run = 0; run < runs; run++)
+    {
+        cout << "Run " << run + 1 << "/" << runs << "\n";
+        vector<string> failed;
+        const vector<BenchmarkResult> results = RunBenchmarks(filter, BENCHMARK_DEFAULT_REPETITIONS, failed);
+
+        // A missing benchmark would be neither compared nor saved in the baseline
+        if (!failed.empty())
+        {
+            return 1;
+        }
+
+        if (run == 0)
+        {
+            current = results;
+            continue;
+        }
+
+        for (size_t index = 0; index < results.size(); index++)
+        {
+            current[index].samples.insert(current[index].samples.end(), results[index].samples.begin(), results[index].samples.end());
+        }
+    }
+
+    for (BenchmarkResult& result : current)
+    {
+        Summarize(result);
+    }
+
+    if (saveBaseline)
+    {
+        filesystem::create_directories(BENCHMARK_BASELINE_DIR);
+
+        if (!SaveBenchmarks(current, baselineFile))
+        {
+            return 1;
+        }
+
+        PrintBenchmarks(current);
+        cout << "Baseline saved: " << baselineFile << "\n";
+        return 0;
+    }
+
+    char line[160];
+    unsigned int regressions = 0;
+
+    cout << "Baseline: " << baselineFile << "\n";
+    snprintf(line, sizeof(line), "%-36s %12s %12s %9s %11s  %s", "Benchmark", "baseline", "current", "change", "confidence", "result");
+    cout << line << "\n";
+
+    for (const BenchmarkResult& result : current)
+    {
+        const auto found = find_if(baseline.begin(), baseline.end(), [&result](const BenchmarkResult& other) { return other.name == result.name; });
+
+        if (found == baseline.end())
+        {
+            snprintf(line, sizeof(line), "%-36s %12s %12.2f %9s %11s  %s", result.name.c_str(), "-", Median(result.samples), "-", "-", "new");
+            cout << line << "\n";
+            continue;
+        }
+
+        const double before = Median(found->samples);
+        const double after = Median(result.samples);
+        const double change = (after - before) / before * 100.0;
+        const double p = MannWhitney(found->samples, result.samples);
+        const bool significant = p < BENCHMARK_ALPHA && fabs(change) > threshold;
+        const char* verdict = !significant ? "same" : change > 0.0 ? "REGRESSION" : "improvement";
+
+        if (significant && change > 0.0)
+        {
+            regressions++;
+        }
+
+        snprintf(line, sizeof(line), "%-36s %12.2f %12.2f %+8.1f%% %10.1f%%  %s", result.name.c_str(), before, after, change, (1.0 - p) * 100.0, verdict);
+        cout << line << "\n";
+    }
+
+    cout << regressions << " regression(s)\n";
+
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,435 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "codec.h"
+
+#include "protocol.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+BitWriter::BitWriter(unsigned char* buffer) : buffer(buffer), size(0), pending(0), pendingBits(0)
+{
+}
+
+void BitWriter::Write(uint32_t value, unsigned int bits)
+{
+    pending |= static_cast<uint64_t>(value & ((1ULL << bits) - 1)) << pendingBits;
+    pendingBits += bits;
+
+    while (pendingBits >= 8)
+    {
+        buffer[size++] = static_cast<unsigned char>(pending);
+        pending >>= 8;
+        pendingBits -= 8;
+    }
+}
+
+size_t BitWriter::Finish()
+{
+    if (pendingBits > 0)
+    {
+        buffer[size++] = static_cast<unsigned char>(pending);
+        pending = 0;
+        pendingBits = 0;
+    }
+
+    return size;
+}
+
+BitReader::BitReader(const unsigned char* buffer, size_t size) : buffer(buffer), size(size), position(0), pending(0), pendingBits(0), valid(true)
+{
+}
+
+uint32_t BitReader::Read(unsigned int bits)
+{
+    while (pendingBits < bits)
+    {
+        if (position == size)
+        {
+            valid = false;
+            return 0;
+        }
+
+        pending |= static_cast<uint64_t>(buffer[position++]) << pendingBits;
+        pendingBits += 8;
+    }
+
+    const uint32_t value = static_cast<uint32_t>(pending & ((1ULL << bits) - 1));
+    pending >>= bits;
+    pendingBits -= bits;
+
+    return value;
+}
+
+bool BitReader::IsValid() const
+{
+    return valid;
+}
+
+void BitReader::Invalidate()
+{
+    valid = false;
+}
+
+// Directions of the ball: serve, and bounces on the rackets with a slope of 0.5
+const Vector2f DIRECTIONS[1 << DIRECTION_BITS]{ { 1.f, 0.f }, { 1.f, 0.5f }, { 1.f, -0.5f }, { -1.f, 0.f }, { -1.f, 0.5f }, { -1.f, -0.5f }, { 0.f, 1.f }, { 0.f, -1.f } };
+
+// Order of the fields in the delta mask
+enum StateField { FieldBallX, FieldBallY, FieldDirection, FieldSpeed, FieldRacketL, FieldRacketR, FieldScoreL, FieldScoreR, FieldWin, FIELD_COUNT };
+static_assert(FIELD_COUNT == STATE_FIELD_COUNT, "The mask of the delta needs one bit per field");
+
+// Quantized values of the fields, in the order of StateField
+struct QuantizedState
+{
+    uint32_t values[FIELD_COUNT];
+};
+
+static const unsigned int FIELD_BITS[FIELD_COUNT]{ BALL_POSITION_BITS, BALL_POSITION_BITS, DIRECTION_BITS, BALL_SPEED_BITS, RACKET_BITS, RACKET_BITS, SCORE_BITS, SCORE_BITS, 1 };
+
+// In double, the sum of the offset would round a float to the closest step in the wrong direction
+static uint32_t Quantize(float value, float scale, float offset, unsigned int bits)
+{
+    const double maximum = static_cast<double>((1u << bits) - 1);
+    return static_cast<uint32_t>(clamp(round((static_cast<double>(value) + offset) * scale), 0., maximum));
+}
+
+// Closest angle of the table
+static uint32_t QuantizeDirection(Vector2f direction)
+{
+    // The simulation only uses the directions of the table
+    for (uint32_t index = 0; index < (1u << DIRECTION_BITS); index++)
+    {
+        if (direction == DIRECTIONS[index])
+        {
+            return index;
+        }
+    }
+
+    uint32_t best = 0;
+    float bestDot = -2.f;
+    const float length = sqrt(direction.x * direction.x + direction.y * direction.y);
+
+    for (uint32_t index = 0; index < (1u << DIRECTION_BITS); index++)
+    {
+        const Vector2f candidate = DIRECTIONS[index];
+        const float dot = (direction.x * candidate.x + direction.y * candidate.y) / (length * sqrt(candidate.x * candidate.x + candidate.y * candidate.y) + 1e-9f);
+
+        if (dot > bestDot)
+        {
+            best = index;
+            bestDot = dot;
+        }
+    }
+
+    return best;
+}
+
+static QuantizedState QuantizeFields(const Simulation::State& state)
+{
+    QuantizedState quantized;
+
+    quantized.values[FieldBallX] = Quantize(state.ballPosition.x, BALL_POSITION_SCALE, BALL_POSITION_OFFSET, BALL_POSITION_BITS);
+    quantized.values[FieldBallY] = Quantize(state.ballPosition.y, BALL_POSITION_SCALE, BALL_POSITION_OFFSET, BALL_POSITION_BITS);
+    quantized.values[FieldDirection] = QuantizeDirection(state.direction);
+    quantized.values[FieldSpeed] = Quantize(state.ballSpeed, BALL_SPEED_SCALE, 0.f, BALL_SPEED_BITS);
+    quantized.values[FieldRacketL] = Quantize(state.racketLY, 1.f, RACKET_OFFSET, RACKET_BITS);
+    quantized.values[FieldRacketR] = Quantize(state.racketRY, 1.f, RACKET_OFFSET, RACKET_BITS);
+    quantized.values[FieldScoreL] = min(state.scoreL, (1u << SCORE_BITS) - 1);
+    quantized.values[FieldScoreR] = min(state.scoreR, (1u << SCORE_BITS) - 1);
+    quantized.values[FieldWin] = state.win ? 1 : 0;
+
+    return quantized;
+}
+
+// Returns false if the value can't come from the encoder
+static bool SetField(Simulation::State& state, StateField field, uint32_t value)
+{
+    switch (field)
+    {
+    case FieldBallX:
+        state.ballPosition.x = static_cast<float>(value) / BALL_POSITION_SCALE - BALL_POSITION_OFFSET;
+        break;
+    case FieldBallY:
+        state.ballPosition.y = static_cast<float>(value) / BALL_POSITION_SCALE - BALL_POSITION_OFFSET;
+        break;
+    case FieldDirection:
+        state.direction = DIRECTIONS[value];
+        break;
+    case FieldSpeed:
+    {
+        // The speed only takes the values of the collision count, computed like the simulation so it is exact
+        const float speed = static_cast<float>(value) / BALL_SPEED_SCALE;
+        state.collisionCount = static_cast<unsigned int>(max(0.f, round((speed - DEFAULT_BALL_SPEED) / BALL_SPEED_INCREASE_VALUE)));
+        state.ballSpeed = DEFAULT_BALL_SPEED + static_cast<float>(state.collisionCount) * BALL_SPEED_INCREASE_VALUE;
+        break;
+    }
+    case FieldRacketL:
+        state.racketLY = static_cast<float>(static_cast<int>(value) - RACKET_OFFSET);
+        break;
+    case FieldRacketR:
+        state.racketRY = static_cast<float>(static_cast<int>(value) - RACKET_OFFSET);
+        break;
+    case FieldScoreL:
+        state.scoreL = value;
+        return value <= MAX_SCORE;
+    case FieldScoreR:
+        state.scoreR = value;
+        return value <= MAX_SCORE;
+    case FieldWin:
+        state.win = value != 0;
+        break;
+    default:
+        break;
+    }
+
+    return true;
+}
+
+void EncodeState(BitWriter& writer, const Simulation::State& state)
+{
+    const QuantizedState quantized = QuantizeFields(state);
+
+    for (unsigned int field = 0; field < FIELD_COUNT; field++)
+    {
+        writer.Write(quantized.values[field], FIELD_BITS[field]);
+    }
+}
+
+void DecodeState(BitReader& reader, Simulation::State& state)
+{
+    for (unsigned int field = 0; field < FIELD_COUNT; field++)
+    {
+        if (!SetField(state, static_cast<StateField>(field), reader.Read(FIELD_BITS[field])))
+        {
+            reader.Invalidate();
+        }
+    }
+}
+
+void EncodeStateDelta(BitWriter& writer, const Simulation::State& previous, const Simulation::State& state)
+{
+    const QuantizedState before = QuantizeFields(previous);
+    const QuantizedState after = QuantizeFields(state);
+
+    uint32_t mask = 0;
+    for (unsigned int field = 0; field < FIELD_COUNT; field++)
+    {
+        if (before.values[field] != after.values[field])
+        {
+            mask |= 1u << field;
+        }
+    }
+
+    writer.Write(mask, FIELD_COUNT);
+
+    for (unsigned int field = 0; field < FIELD_COUNT; field++)
+    {
+        if (mask & (1u << field))
+        {
+            writer.Write(after.values[field], FIELD_BITS[field]);
+        }
+    }
+}
+
+void DecodeStateDelta(BitReader& reader, Simulation::State& state)
+{
+    const uint32_t mask = reader.Read(FIELD_COUNT);
+
+    for (unsigned int field = 0; field < FIELD_COUNT; field++)
+    {
+        if ((mask & (1u << field)) && !SetField(state, static_cast<StateField>(field), reader.Read(FIELD_BITS[field])))
+        {
+            reader.Invalidate();
+        }
+    }
+}
+
+Simulation::State QuantizeState(const Simulation::State& state)
+{
+    const QuantizedState quantized = QuantizeFields(state);
+    Simulation::State result{};
+
+    for (unsigned int field = 0; field < FIELD_COUNT; field++)
+    {
+        SetField(result, static_cast<StateField>(field), quantized.values[field]);
+    }
+
+    return result;
+}
+
+void EncodeButtons(BitWriter& writer, const Input::Button& button)
+{
+    writer.Write((button.Z ? 1 : 0) | (button.S ? 2 : 0) | (button.up ? 4 : 0) | (button.down ? 8 : 0) |
+        (button.escape ? 16 : 0) | (button.space ? 32 : 0), BUTTON_BITS);
+}
+
+Input::Button DecodeButtons(BitReader& reader)
+{
+    const uint32_t mask = reader.Read(BUTTON_BITS);
+    Input::Button button{};
+
+    button.Z = (mask & 1) != 0;
+    button.S = (mask & 2) != 0;
+    button.up = (mask & 4) != 0;
+    button.down = (mask & 8) != 0;
+    button.escape = (mask & 16) != 0;
+    button.space = (mask & 32) != 0;
+
+    return button;
+}
+
+// Any state the simulation can reach, and a bit more
+static Simulation::State RandomState(mt19937& random)
+{
+    uniform_real_distribution<float> ballX(-20.f, WINDOW_WIDTH + 20.f);
+    uniform_real_distribution<float> ballY(-20.f, WINDOW_HEIGHT + 20.f);
+    uniform_int_distribution<int> direction(0, 5);
+    uniform_int_distribution<unsigned int> collisions(0, 300);
+    uniform_int_distribution<int> racket(-6, RACKET_L_MAX_POS_Y + 6);
+    uniform_int_distribution<unsigned int> score(0, MAX_SCORE);
+
+    Simulation::State state;
+    state.ballPosition = Vector2f(ballX(random), ballY(random));
+    state.direction = DIRECTIONS[direction(random)];
+    state.collisionCount = collisions(random);
+    state.ballSpeed = DEFAULT_BALL_SPEED + static_cast<float>(state.collisionCount) * BALL_SPEED_INCREASE_VALUE;
+    state.racketLY = static_cast<float>(racket(random));
+    state.racketRY = static_cast<float>(racket(random));
+    state.scoreL = score(random);
+    state.scoreR = score(random);
+    state.win = state.scoreL == MAX_SCORE || state.scoreR == MAX_SCORE;
+
+    return state;
+}
+
+// Ranges of the fields after a decoding
+static bool IsInRange(const Simulation::State& state)
+{
+    const float minimumPosition = -BALL_POSITION_OFFSET;
+    const float maximumPosition = static_cast<float>((1u << BALL_POSITION_BITS) - 1) / BALL_POSITION_SCALE - BALL_POSITION_OFFSET;
+
+    return state.scoreL <= MAX_SCORE && state.scoreR <= MAX_SCORE && find(begin(DIRECTIONS), end(DIRECTIONS), state.direction) != end(DIRECTIONS) &&
+        state.ballPosition.x >= minimumPosition && state.ballPosition.x <= maximumPosition && state.ballPosition.y >= minimumPosition &&
+        state.ballPosition.y <= maximumPosition && state.ballSpeed >= DEFAULT_BALL_SPEED && state.racketLY >= -RACKET_OFFSET && state.racketRY >= -RACKET_OFFSET;
+}
+
+static bool IsEqual(const Simulation::State& a, const Simulation::State& b)
+{
+    return a.ballPosition == b.ballPosition && a.direction == b.direction && a.ballSpeed == b.ballSpeed && a.racketLY == b.racketLY &&
+        a.racketRY == b.racketRY && a.scoreL == b.scoreL && a.scoreR == b.scoreR && a.collisionCount == b.collisionCount && a.win == b.win;
+}
+
+int RunCodecFuzz(int argc, char* argv[])
+{
+    const unsigned int iterations = argc > 2 ? static_cast<unsigned int>(stoul(argv[2])) : 1000000;
+    mt19937 random(12345);
+    unsigned int failures = 0;
+    size_t maxStateSize = 0;
+    size_t maxDeltaSize = 0;
+
+    const auto fail = [&](const char* test, unsigned int iteration)
+    {
+        if (failures++ < 10)
+        {
+            cout << test << " failed at iteration " << iteration << '\n';
+        }
+    };
+
+    for (unsigned int iteration = 0; iteration < iterations; iteration++)
+    {
+        const Simulation::State state = RandomState(random);
+        const Simulation::State previous = random() % 4 == 0 ? RandomState(random) : state;
+        const uint32_t tick = random();
+        unsigned char packet[MAX_PACKET_SIZE];
+        uint32_t decodedTick;
+
+        // Full state: the exact quantized state, and the ball less than half a step away
+        const size_t stateSize = WriteState(packet, tick, state);
+        maxStateSize = max(maxStateSize, stateSize);
+        Simulation::State decoded;
+        if (ReadState(packet, stateSize, decodedTick, decoded) != stateSize || decodedTick != (tick & 0xFFFF) || !IsEqual(decoded, QuantizeState(state)) ||
+            abs(decoded.ballPosition.x - state.ballPosition.x) > 0.5f / BALL_POSITION_SCALE || abs(decoded.ballPosition.y - state.ballPosition.y) > 0.5f / BALL_POSITION_SCALE ||
+            decoded.ballSpeed != state.ballSpeed || decoded.collisionCount != state.collisionCount)
+        {
+            fail("State", iteration);
+        }
+
+        // Delta applied to the previous state as the receiver knows it
+        unsigned char frame[MAX_FRAME_SIZE];
+        const size_t deltaSize = WriteDelta(frame, tick, previous, state);
+        maxDeltaSize = max(maxDeltaSize, deltaSize);
+        Simulation::State applied = QuantizeState(previous);
+        FrameType type;
+        if (ReadFrame(frame, deltaSize, decodedTick, applied, type) != deltaSize || type != FrameDelta || !IsEqual(applied, QuantizeState(state)))
+        {
+            fail("Delta", iteration);
+        }
+
+        // Inputs
+        Input::Button button{};
+        button.Z = random() % 2;
+        button.S = random() % 2;
+        button.up = random() % 2;
+        button.down = random() % 2;
+        button.escape = random() % 2;
+        button.space = random() % 2;
+        Input::Button decodedButton;
+        const size_t inputSize = WriteInput(packet, tick, button);
+        if (ReadInput(packet, inputSize, decodedTick, decodedButton) != inputSize || decodedButton.Z != button.Z || decodedButton.S != button.S ||
+            decodedButton.up != button.up || decodedButton.down != button.down || decodedButton.escape != button.escape || decodedButton.space != button.space)
+        {
+            fail("Input", iteration);
+        }
+
+        // Truncated state packets are rejected, the packet holds the input above so the state is written again
+        WriteState(packet, tick, state);
+        if (ReadState(packet, random() % stateSize, decodedTick, decoded) != 0)
+        {
+            fail("Truncated state", iteration);
+        }
+
+        // Random bytes must not crash, and a decoded state stays in the ranges of the codec
+        for (unsigned char& byte : packet)
+        {
+            byte = static_cast<unsigned char>(random());
+        }
+        if (ReadState(packet, random() % MAX_PACKET_SIZE, decodedTick, decoded) && !IsInRange(decoded))
+        {
+            fail("Random bytes", iteration);
+        }
+        if (ReadFrame(packet, random() % MAX_PACKET_SIZE, decodedTick, applied, type) && !IsInRange(applied))
+        {
+            fail("Random frame", iteration);
+        }
+    }
+
+    cout << "Iterations: " << iterations << ", state packet " << maxStateSize << " bytes (" << STATE_BITS << " bits of state), largest delta frame "
+        << maxDeltaSize << " bytes\n";
+    cout << (failures == 0 ? "Round trips OK\n" : to_string(failures) + " failures\n");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,405 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "determinism.h"
+
+#include "ai.h"
+#include "hash.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+const char DETERMINISM_MAGIC[4]{ 'P', 'D', 'E', 'T' };
+const uint32_t DETERMINISM_VERSION{ 1 };
+
+static void Write32(unsigned char*& bytes, uint32_t value)
+{
+    for (int index = 0; index < 4; index++)
+    {
+        *bytes++ = static_cast<unsigned char>(value >> (index * 8));
+    }
+}
+
+static uint32_t Read32(const unsigned char*& bytes)
+{
+    uint32_t value = 0;
+
+    for (int index = 0; index < 4; index++)
+    {
+        value |= static_cast<uint32_t>(*bytes++) << (index * 8);
+    }
+
+    return value;
+}
+
+// Floats are written bit for bit, so -0 and 0 or two NaN are different states
+static void WriteFloat(unsigned char*& bytes, float value)
+{
+    Write32(bytes, bit_cast<uint32_t>(value));
+}
+
+static float ReadFloat(const unsigned char*& bytes)
+{
+    return bit_cast<float>(Read32(bytes));
+}
+
+void SerializeState(const Simulation::State& state, unsigned char* bytes)
+{
+    WriteFloat(bytes, state.ballPosition.x);
+    WriteFloat(bytes, state.ballPosition.y);
+    WriteFloat(bytes, state.direction.x);
+    WriteFloat(bytes, state.direction.y);
+    WriteFloat(bytes, state.ballSpeed);
+    WriteFloat(bytes, state.racketLY);
+    WriteFloat(bytes, state.racketRY);
+    Write32(bytes, state.scoreL);
+    Write32(bytes, state.scoreR);
+    Write32(bytes, state.collisionCount);
+    *bytes = state.win ? 1 : 0;
+}
+
+Simulation::State DeserializeState(const unsigned char* bytes)
+{
+    Simulation::State state;
+
+    state.ballPosition.x = ReadFloat(bytes);
+    state.ballPosition.y = ReadFloat(bytes);
+    state.direction.x = ReadFloat(bytes);
+    state.direction.y = ReadFloat(bytes);
+    state.ballSpeed = ReadFloat(bytes);
+    state.racketLY = ReadFloat(bytes);
+    state.racketRY = ReadFloat(bytes);
+    state.scoreL = Read32(bytes);
+    state.scoreR = Read32(bytes);
+    state.collisionCount = Read32(bytes);
+    state.win = *bytes != 0;
+
+    return state;
+}
+
+unsigned long long HashState(const Simulation::State& state)
+{
+    unsigned char bytes[STATE_SIZE];
+    SerializeState(state, bytes);
+
+    return XxHash64(bytes, STATE_SIZE);
+}
+
+unsigned char PackInput(const Input::Button& button)
+{
+    return (button.Z ? 1 : 0) | (button.S ? 2 : 0) | (button.up ? 4 : 0) | (button.down ? 8 : 0);
+}
+
+Input::Button UnpackInput(unsigned char input)
+{
+    Input::Button button{};
+
+    button.Z = (input & 1) != 0;
+    button.S = (input & 2) != 0;
+    button.up = (input & 4) != 0;
+    button.down = (input & 8) != 0;
+
+    return button;
+}
+
+vector<unsigned char> GenerateInputs(unsigned int ticks, unsigned int seed)
+{
+    vector<unsigned char> inputs;
+    inputs.reserve(ticks);
+
+    Simulation simulation;
+    AI cpuL(PlayerLeft, CPU_REACTION_DELAY, CPU_AIM_ERROR, seed * 2);
+    AI cpuR(PlayerRight, CPU_REACTION_DELAY, CPU_AIM_ERROR, seed * 2 + 1);
+    Collision collision = None;
+
+    for (unsigned int tick = 0; tick < ticks; tick++)
+    {
+        const Simulation::State& state = simulation.GetState();
+        Input::Button button{};
+
+        cpuL.Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
+        cpuL.Control(button, state.racketLY);
+        cpuR.Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
+        cpuR.Control(button, state.racketRY);
+
+        inputs.push_back(PackInput(button));
+        collision = simulation.Step(button);
+
+        if (simulation.GetState().win)
+        {
+            simulation.Reset();
+            cpuL.Reset();
+            cpuR.Reset();
+            collision = None;
+        }
+    }
+
+    return inputs;
+}
+
+vector<Simulation::State> ReplayInputs(const vector<unsigned char>& inputs)
+{
+    vector<Simulation::State> states;
+    states.reserve(inputs.size());
+
+    Simulation simulation;
+
+    for (unsigned char input : inputs)
+    {
+        simulation.Step(UnpackInput(input));
+        states.push_back(simulation.GetState());
+
+        if (simulation.GetState().win)
+        {
+            simulation.Reset();
+        }
+    }
+
+    return states;
+}
+
+// Value and bits of a float, the bits show differences smaller than the printed precision
+static void PrintField(const string& name, float expected, float actual)
+{
+    cout << "  " << left << setw(16) << name << right << setprecision(9) << expected << " (0x" << hex << bit_cast<uint32_t>(expected) << dec << ")"
+        << (expected == actual && bit_cast<uint32_t>(expected) == bit_cast<uint32_t>(actual) ? "    " : " != ")
+        << actual << " (0x" << hex << bit_cast<uint32_t>(actual) << dec << ")\n";
+}
+
+static void PrintField(const string& name, unsigned int expected, unsigned int actual)
+{
+    cout << "  " << left << setw(16) << name << right << expected << (expected == actual ? "    " : " != ") << actual << '\n';
+}
+
+long long FindDivergence(const vector<Simulation::State>& expected, const vector<Simulation::State>& actual)
+{
+    const size_t ticks = min(expected.size(), actual.size());
+
+    for (size_t tick = 0; tick < ticks; tick++)
+    {
+        if (HashState(expected[tick]) == HashState(actual[tick]))
+        {
+            continue;
+        }
+
+        const Simulation::State& a = expected[tick];
+        const Simulation::State& b = actual[tick];
+
+        cout << "Divergence at tick " << tick << " (hash " << hex << HashState(a) << " != " << HashState(b) << dec << ")\n";
+        PrintField("ball x", a.ballPosition.x, b.ballPosition.x);
+        PrintField("ball y", a.ballPosition.y, b.ballPosition.y);
+        PrintField("direction x", a.direction.x, b.direction.x);
+        PrintField("direction y", a.direction.y, b.direction.y);
+        PrintField("ball speed", a.ballSpeed, b.ballSpeed);
+        PrintField("racket L y", a.racketLY, b.racketLY);
+        PrintField("racket R y", a.racketRY, b.racketRY);
+        PrintField("score L", a.scoreL, b.scoreL);
+        PrintField("score R", a.scoreR, b.scoreR);
+        PrintField("collisions", a.collisionCount, b.collisionCount);
+        PrintField("win", a.win ? 1u : 0u, b.win ? 1u : 0u);
+
+        return static_cast<long long>(tick);
+    }
+
+    if (expected.size() != actual.size())
+    {
+        cout << "Divergence at tick " << ticks << " (" << expected.size() << " ticks expected, " << actual.size() << " replayed)\n";
+        return static_cast<long long>(ticks);
+    }
+
+    return -1;
+}
+
+// Hash of the whole run, each state hash is seeded with the previous one
+static unsigned long long HashRun(const vector<Simulation::State>& states)
+{
+    unsigned long long hash = 0;
+    unsigned char bytes[STATE_SIZE];
+
+    for (const Simulation::State& state : states)
+    {
+        SerializeState(state, bytes);
+        hash = XxHash64(bytes, STATE_SIZE, hash);
+    }
+
+    return hash;
+}
+
+// Header, then for each tick : input, hash and serialized state
+static bool SaveRun(const string& fileName, const vector<unsigned char>& inputs, const vector<Simulation::State>& states)
+{
+    ofstream file(fileName, ios::binary);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    unsigned char header[12];
+    unsigned char* bytes = header;
+    for (char letter : DETERMINISM_MAGIC)
+    {
+        *bytes++ = static_cast<unsigned char>(letter);
+    }
+    Write32(bytes, DETERMINISM_VERSION);
+    Write32(bytes, static_cast<uint32_t>(inputs.size()));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    unsigned char record[1 + 8 + STATE_SIZE];
+
+    for (size_t tick = 0; tick < inputs.size(); tick++)
+    {
+        const unsigned long long hash = HashState(states[tick]);
+
+        record[0] = inputs[tick];
+        for (int index = 0; index < 8; index++)
+        {
+            record[1 + index] = static_cast<unsigned char>(hash >> (index * 8));
+        }
+        SerializeState(states[tick], record + 9);
+
+        file.write(reinterpret_cast<const char*>(record), sizeof(record));
+    }
+
+    return static_cast<bool>(file);
+}
+
+static bool LoadRun(const string& fileName, vector<unsigned char>& inputs, vector<Simulation::State>& states)
+{
+    ifstream file(fileName, ios::binary);
+    unsigned char header[12];
+
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) || !equal(DETERMINISM_MAGIC, DETERMINISM_MAGIC + 4, header))
+    {
+        return false;
+    }
+
+    const unsigned char* bytes = header + 4;
+    if (Read32(bytes) != DETERMINISM_VERSION)
+    {
+        return false;
+    }
+    const uint32_t ticks = Read32(bytes);
+    unsigned char record[1 + 8 + STATE_SIZE];
+
+    // The file must hold every record of the header before they are allocated
+    const streampos recordsStart = file.tellg();
+    file.seekg(0, ios::end);
+    const streampos fileEnd = file.tellg();
+    file.seekg(recordsStart);
+
+    if (recordsStart < 0 || fileEnd < 0 || static_cast<unsigned long long>(fileEnd - recordsStart) != static_cast<unsigned long long>(ticks) * sizeof(record))
+    {
+        cout << "The file doesn't contain the " << ticks << " ticks of its header\n";
+        return false;
+    }
+
+    inputs.resize(ticks);
+    states.resize(ticks);
+
+    for (uint32_t tick = 0; tick < ticks; tick++)
+    {
+        if (!file.read(reinterpret_cast<char*>(record), sizeof(record)))
+        {
+            return false;
+        }
+
+        inputs[tick] = record[0];
+        states[tick] = DeserializeState(record + 9);
+
+        // The hash is recomputed from the state, so a corrupted record is detected
+        const unsigned char* hashBytes = record + 1;
+        const unsigned long long hash = static_cast<unsigned long long>(Read32(hashBytes)) | static_cast<unsigned long long>(Read32(hashBytes)) << 32;
+        if (hash != HashState(states[tick]))
+        {
+            cout << "Corrupted record at tick " << tick << '\n';
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int RunDeterminism(int argc, char* argv[])
+{
+    const string mode = argv[1];
+
+    if (mode == "--determinism-verify")
+    {
+        vector<unsigned char> inputs;
+        vector<Simulation::State> expected;
+
+        if (argc < 3 || !LoadRun(argv[2], inputs, expected))
+        {
+            cout << "Cannot read the determinism file\n";
+            return 1;
+        }
+
+        const vector<Simulation::State> actual = ReplayInputs(inputs);
+        const long long divergence = FindDivergence(expected, actual);
+
+        cout << "Ticks: " << inputs.size() << ", recorded hash " << hex << HashRun(expected) << ", replayed hash " << HashRun(actual) << dec << '\n';
+        cout << (divergence < 0 ? "Deterministic\n" : "NOT deterministic\n");
+
+        return divergence < 0 ? 0 : 1;
+    }
+
+    // The record mode takes the file name first
+    const int first = mode == "--determinism-record" ? 3 : 2;
+    const unsigned int ticks = argc > first ? static_cast<unsigned int>(stoul(argv[first])) : DETERMINISM_TICKS;
+    const unsigned int seed = argc > first + 1 ? static_cast<unsigned int>(stoul(argv[first + 1])) : DETERMINISM_SEED;
+
+    const vector<unsigned char> inputs = GenerateInputs(ticks, seed);
+
+    if (mode == "--determinism-record")
+    {
+        const vector<Simulation::State> states = ReplayInputs(inputs);
+
+        if (argc < 3 || !SaveRun(argv[2], inputs, states))
+        {
+            cout << "Cannot write the determinism file\n";
+            return 1;
+        }
+
+        cout << "Ticks: " << ticks << ", hash " << hex << HashRun(states) << dec << '\n';
+        return 0;
+    }
+
+    // Same inputs on this thread and on another one
+    vector<Simulation::State> threadStates;
+    thread worker([&]() { threadStates = ReplayInputs(inputs); });
+    const vector<Simulation::State> states = ReplayInputs(inputs);
+    worker.join();
+
+    const long long divergence = FindDivergence(states, threadStates);
+
+    cout << "Ticks: " << ticks << ", hash " << hex << HashRun(states) << ", other thread " << HashRun(threadStates) << dec << '\n';
+    cout << (divergence < 0 ? "Deterministic\n" : "NOT deterministic\n");
+
+    return divergence < 0 ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "eventbus.h"
+
+#include <algorithm>
+#include <bit>
+
+EventBus::EventBus(size_t capacity) : capacity(bit_ceil(max<size_t>(2, capacity))), dropped(0)
+{
+}
+
+unsigned int EventBus::Subscribe()
+{
+    queues.push_back(make_unique<Queue>(capacity));
+    return static_cast<unsigned int>(queues.size() - 1);
+}
+
+bool EventBus::Publish(const GameEvent& event)
+{
+    bool published = true;
+
+    for (const unique_ptr<Queue>& queue : queues)
+    {
+        if (!queue->Push(event))
+        {
+            dropped.fetch_add(1, memory_order_relaxed);
+            published = false;
+        }
+    }
+    return published;
+}
+
+unsigned long long EventBus::GetDroppedCount() const
+{
+    return dropped.load(memory_order_relaxed);
+}
+
+// The cell at index i is free for the position i, then for i + capacity once it is read
+EventBus::Queue::Queue(size_t capacity) : cells(new Cell[capacity]), mask(capacity - 1), tail(0), head(0)
+{
+    for (size_t index = 0; index < capacity; index++)
+    {
+        cells[index].sequence.store(index, memory_order_relaxed);
+    }
+}
+
+bool EventBus::Queue::Push(const GameEvent& event)
+{
+    size_t position = tail.load(memory_order_relaxed);
+
+    while (true)
+    {
+        Cell& cell = cells[position & mask];
+        const size_t sequence = cell.sequence.load(memory_order_acquire);
+        const ptrdiff_t difference = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(position);
+
+        if (difference == 0)
+        {
+            // Claim the cell, another producer may have taken it first
+            if (tail.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+            {
+                cell.event = event;
+                cell.sequence.store(position + 1, memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The consumer hasn't read the cell yet: full
+            return false;
+        }
+        else
+        {
+            position = tail.load(memory_order_relaxed);
+        }
+    }
+}
+
+bool EventBus::Queue::Pop(GameEvent& event)
+{
+    Cell& cell = cells[head & mask];
+
+    if (cell.sequence.load(memory_order_acquire) != head + 1)
+    {
+        return false;
+    }
+
+    event = cell.event;
+    cell.sequence.store(head + mask + 1, memory_order_release);
+    head++;
+    return true;
+}
@@ -0,0 +1,154 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "glyphatlas.h"
+
+#include <algorithm>
+#include <map>
+
+// Width of the atlas, it grows in height
+const unsigned int GLYPH_ATLAS_WIDTH{ 512 };
+
+void GlyphAtlas::Add(unsigned int characterSize, const String& characters)
+{
+    requests.push_back(make_pair(characterSize, characters));
+}
+
+bool GlyphAtlas::Build(const Font& font)
+{
+    struct Pending
+    {
+        uint64_t key;
+        unsigned int characterSize;
+        // In the page of the font
+        IntRect source;
+        Glyph glyph;
+    };
+
+    vector<Pending> pending;
+
+    // Rasterize every glyph first, the pages of the font are only read once complete
+    for (const pair<unsigned int, String>& request : requests)
+    {
+        for (const Uint32 character : request.second)
+        {
+            const uint64_t key = GetKey(character, request.first);
+
+            if (glyphs.count(key) || any_of(pending.begin(), pending.end(), [key](const Pending& other) { return other.key == key; }))
+            {
+                continue;
+            }
+
+            const sf::Glyph& glyph = font.getGlyph(character, request.first, false);
+            Pending entry;
+            entry.key = key;
+            entry.characterSize = request.first;
+            entry.source = IntRect(glyph.textureRect.left - GLYPH_ATLAS_PADDING, glyph.textureRect.top - GLYPH_ATLAS_PADDING,
+                glyph.textureRect.width + 2 * GLYPH_ATLAS_PADDING, glyph.textureRect.height + 2 * GLYPH_ATLAS_PADDING);
+            entry.glyph.advance = glyph.advance;
+            entry.glyph.bounds = glyph.bounds;
+            pending.push_back(entry);
+        }
+    }
+
+    // Highest glyphs first, packed in rows
+    sort(pending.begin(), pending.end(), [](const Pending& first, const Pending& second) { return first.source.height > second.source.height; });
+
+    int x = 0;
+    int y = 0;
+    int rowHeight = 0;
+
+    for (Pending& entry : pending)
+    {
+        // Spaces only have an advance
+        if (entry.glyph.bounds.width == 0.f || entry.glyph.bounds.height == 0.f)
+        {
+            entry.glyph.textureRect = IntRect();
+            continue;
+        }
+
+        if (x + entry.source.width > static_cast<int>(GLYPH_ATLAS_WIDTH))
+        {
+            x = 0;
+            y += rowHeight;
+            rowHeight = 0;
+        }
+
+        entry.glyph.textureRect = IntRect(x, y, entry.source.width, entry.source.height);
+        x += entry.source.width;
+        rowHeight = max(rowHeight, entry.source.height);
+    }
+
+    // One read back of the page of each size
+    map<unsigned int, Image> pages;
+
+    for (const Pending& entry : pending)
+    {
+        if (entry.glyph.textureRect.width > 0 && !pages.count(entry.characterSize))
+        {
+            pages[entry.characterSize] = font.getTexture(entry.characterSize).copyToImage();
+        }
+    }
+
+    Image image;
+    image.create(GLYPH_ATLAS_WIDTH, static_cast<unsigned int>(max(1, y + rowHeight)), Color(255, 255, 255, 0));
+
+    for (const Pending& entry : pending)
+    {
+        if (entry.glyph.textureRect.width > 0)
+        {
+            image.copy(pages[entry.characterSize], static_cast<unsigned int>(entry.glyph.textureRect.left), static_cast<unsigned int>(entry.glyph.textureRect.top), entry.source);
+        }
+        glyphs[entry.key] = entry.glyph;
+    }
+
+    if (!texture.loadFromImage(image))
+    {
+        return false;
+    }
+    texture.setSmooth(true);
+
+    return true;
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::Find(Uint32 character, unsigned int characterSize) const
+{
+    const auto glyph = glyphs.find(GetKey(character, characterSize));
+    return glyph != glyphs.end() ? &glyph->second : nullptr;
+}
+
+const Texture& GlyphAtlas::GetTexture() const
+{
+    return texture;
+}
+
+size_t GlyphAtlas::GetGlyphCount() const
+{
+    return glyphs.size();
+}
+
+uint64_t GlyphAtlas::GetKey(Uint32 character, unsigned int characterSize)
+{
+    return static_cast<uint64_t>(characterSize) << 32 | character;
+}
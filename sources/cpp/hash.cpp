@@ -0,0 +1,136 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "hash.h"
+
+const unsigned long long PRIME_1{ 0x9E3779B185EBCA87ULL };
+const unsigned long long PRIME_2{ 0xC2B2AE3D27D4EB4FULL };
+const unsigned long long PRIME_3{ 0x165667B19E3779F9ULL };
+const unsigned long long PRIME_4{ 0x85EBCA77C2B2AE63ULL };
+const unsigned long long PRIME_5{ 0x27D4EB2F165667C5ULL };
+
+static unsigned long long RotateLeft(unsigned long long value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Little-endian reads, independent of the platform
+static unsigned long long Read64(const unsigned char* bytes)
+{
+    unsigned long long value = 0;
+
+    for (int index = 7; index >= 0; index--)
+    {
+        value = (value << 8) | bytes[index];
+    }
+
+    return value;
+}
+
+static unsigned long long Read32(const unsigned char* bytes)
+{
+    return static_cast<unsigned long long>(bytes[0]) | static_cast<unsigned long long>(bytes[1]) << 8 |
+        static_cast<unsigned long long>(bytes[2]) << 16 | static_cast<unsigned long long>(bytes[3]) << 24;
+}
+
+static unsigned long long Round(unsigned long long accumulator, unsigned long long input)
+{
+    accumulator += input * PRIME_2;
+    accumulator = RotateLeft(accumulator, 31);
+    return accumulator * PRIME_1;
+}
+
+static unsigned long long MergeRound(unsigned long long accumulator, unsigned long long value)
+{
+    accumulator ^= Round(0, value);
+    return accumulator * PRIME_1 + PRIME_4;
+}
+
+unsigned long long XxHash64(const void* data, size_t size, unsigned long long seed)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const unsigned char* end = bytes + size;
+    unsigned long long hash;
+
+    // Four lanes of 8 bytes
+    if (size >= 32)
+    {
+        unsigned long long lane1 = seed + PRIME_1 + PRIME_2;
+        unsigned long long lane2 = seed + PRIME_2;
+        unsigned long long lane3 = seed;
+        unsigned long long lane4 = seed - PRIME_1;
+
+        while (end - bytes >= 32)
+        {
+            lane1 = Round(lane1, Read64(bytes));
+            lane2 = Round(lane2, Read64(bytes + 8));
+            lane3 = Round(lane3, Read64(bytes + 16));
+            lane4 = Round(lane4, Read64(bytes + 24));
+            bytes += 32;
+        }
+
+        hash = RotateLeft(lane1, 1) + RotateLeft(lane2, 7) + RotateLeft(lane3, 12) + RotateLeft(lane4, 18);
+        hash = MergeRound(hash, lane1);
+        hash = MergeRound(hash, lane2);
+        hash = MergeRound(hash, lane3);
+        hash = MergeRound(hash, lane4);
+    }
+    else
+    {
+        hash = seed + PRIME_5;
+    }
+
+    hash += size;
+
+    // Remaining bytes
+    while (end - bytes >= 8)
+    {
+        hash ^= Round(0, Read64(bytes));
+        hash = RotateLeft(hash, 27) * PRIME_1 + PRIME_4;
+        bytes += 8;
+    }
+
+    if (end - bytes >= 4)
+    {
+        hash ^= Read32(bytes) * PRIME_1;
+        hash = RotateLeft(hash, 23) * PRIME_2 + PRIME_3;
+        bytes += 4;
+    }
+
+    while (bytes < end)
+    {
+        hash ^= *bytes * PRIME_5;
+        hash = RotateLeft(hash, 11) * PRIME_1;
+        bytes++;
+    }
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
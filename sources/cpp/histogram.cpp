@@ -0,0 +1,199 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <fstream>
+
+// Each power of two is split in SUB_BUCKETS buckets, values below 2 * SUB_BUCKETS have their own bucket
+const unsigned int SUB_BUCKET_BITS{ 6 };
+const unsigned long long SUB_BUCKETS{ 1ULL << SUB_BUCKET_BITS };
+const unsigned long long HISTOGRAM_MIN{ 1 };
+const unsigned long long HISTOGRAM_MAX{ 10000000 };
+
+// Constructor
+Histogram::Histogram()
+    : counts(GetIndex(HISTOGRAM_MAX) + 1)
+{
+    Reset();
+}
+
+void Histogram::Record(double microseconds)
+{
+    const unsigned long long value = clamp(static_cast<unsigned long long>(microseconds), HISTOGRAM_MIN, HISTOGRAM_MAX);
+
+    counts[GetIndex(value)]++;
+    count++;
+    sum += microseconds;
+    maximum = max(maximum, microseconds);
+}
+
+// Add the values of another histogram, for instance from another run
+void Histogram::Merge(const Histogram& other)
+{
+    for (size_t index = 0; index < counts.size(); index++)
+    {
+        counts[index] += other.counts[index];
+    }
+
+    count += other.count;
+    sum += other.sum;
+    maximum = max(maximum, other.maximum);
+}
+
+void Histogram::Reset()
+{
+    fill(counts.begin(), counts.end(), 0ULL);
+    count = 0;
+    sum = 0.0;
+    maximum = 0.0;
+}
+
+unsigned long long Histogram::GetCount() const
+{
+    return count;
+}
+
+double Histogram::GetMean() const
+{
+    return count > 0 ? sum / static_cast<double>(count) : 0.0;
+}
+
+double Histogram::GetMax() const
+{
+    return maximum;
+}
+
+double Histogram::GetPercentile(double percentile) const
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    const unsigned long long rank = max(1ULL, static_cast<unsigned long long>(percentile / 100.0 * static_cast<double>(count) + 0.5));
+    unsigned long long seen = 0;
+
+    for (size_t index = 0; index < counts.size(); index++)
+    {
+        seen += counts[index];
+
+        if (seen >= rank)
+        {
+            // Never report more than the real maximum
+            return min(static_cast<double>(GetUpperValue(index)), maximum);
+        }
+    }
+
+    return maximum;
+}
+
+void Histogram::Report(const string& name, ostream& stream) const
+{
+    char line[200];
+
+    snprintf(line, sizeof(line), "%-12s count %-9llu mean %9.1f us  p50 %9.1f  p90 %9.1f  p99 %9.1f  p99.9 %9.1f  max %9.1f us",
+        name.c_str(), count, GetMean(), GetPercentile(50.0), GetPercentile(90.0), GetPercentile(99.0), GetPercentile(99.9), maximum);
+    stream << line << "\n";
+}
+
+// Text file: count, sum and maximum on the first line, then "bucket count" for each bucket in use
+bool Histogram::SaveToFile(const string& fileName) const
+{
+    ofstream file(fileName);
+
+    if (!file)
+    {
+        cerr << "Error writing histogram file: " << fileName << "\n";
+        return false;
+    }
+
+    file.precision(17);
+    file << count << " " << sum << " " << maximum << "\n";
+
+    for (size_t index = 0; index < counts.size(); index++)
+    {
+        if (counts[index] > 0)
+        {
+            file << index << " " << counts[index] << "\n";
+        }
+    }
+
+    return true;
+}
+
+bool Histogram::LoadFromFile(const string& fileName)
+{
+    ifstream file(fileName);
+    Histogram loaded;
+
+    if (!(file >> loaded.count >> loaded.sum >> loaded.maximum))
+    {
+        cerr << "Error loading histogram file: " << fileName << "\n";
+        return false;
+    }
+
+    size_t index;
+    unsigned long long value;
+
+    while (file >> index >> value)
+    {
+        if (index < loaded.counts.size())
+        {
+            loaded.counts[index] = value;
+        }
+    }
+
+    *this = loaded;
+    return true;
+}
+
+size_t Histogram::GetIndex(unsigned long long value)
+{
+    if (value < SUB_BUCKETS * 2)
+    {
+        return static_cast<size_t>(value);
+    }
+
+    // The SUB_BUCKET_BITS + 1 highest bits of the value
+    const unsigned int shift = static_cast<unsigned int>(bit_width(value)) - SUB_BUCKET_BITS - 1;
+
+    return static_cast<size_t>(shift * SUB_BUCKETS + (value >> shift));
+}
+
+unsigned long long Histogram::GetUpperValue(size_t index)
+{
+    if (index < SUB_BUCKETS * 2)
+    {
+        return index;
+    }
+
+    const unsigned long long shift = index / SUB_BUCKETS - 1;
+    const unsigned long long subBucket = index % SUB_BUCKETS + SUB_BUCKETS;
+
+    return ((subBucket + 1) << shift) - 1;
+}
@@ -0,0 +1,155 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "hudtext.h"
+
+#include <algorithm>
+
+using namespace std;
+
+HudText::HudText() : atlas(nullptr), characterSize(30), color(Color::White)
+{
+}
+
+HudText::HudText(const String& string, const GlyphAtlas& atlas, unsigned int characterSize)
+    : atlas(&atlas), string(string), characterSize(characterSize), color(Color::White)
+{
+    UpdateBounds();
+}
+
+void HudText::SetString(const String& newString)
+{
+    string = newString;
+    UpdateBounds();
+}
+
+void HudText::SetCharacterSize(unsigned int newSize)
+{
+    characterSize = newSize;
+    UpdateBounds();
+}
+
+void HudText::SetFillColor(Color newColor)
+{
+    color = newColor;
+}
+
+void HudText::SetPosition(float x, float y)
+{
+    position = Vector2f(x, y);
+}
+
+FloatRect HudText::GetLocalBounds() const
+{
+    return bounds;
+}
+
+// The baseline is at characterSize pixels under the position, like sf::Text
+void HudText::Append(VertexArray& vertices) const
+{
+    if (!atlas)
+    {
+        return;
+    }
+
+    const float padding = static_cast<float>(GLYPH_ATLAS_PADDING);
+    const float baseline = position.y + static_cast<float>(characterSize);
+    float x = position.x;
+
+    for (const Uint32 character : string)
+    {
+        const GlyphAtlas::Glyph* glyph = atlas->Find(character, characterSize);
+
+        if (!glyph)
+        {
+            continue;
+        }
+
+        if (glyph->textureRect.width > 0)
+        {
+            const float left = x + glyph->bounds.left - padding;
+            const float top = baseline + glyph->bounds.top - padding;
+            const float right = x + glyph->bounds.left + glyph->bounds.width + padding;
+            const float bottom = baseline + glyph->bounds.top + glyph->bounds.height + padding;
+
+            const float u1 = static_cast<float>(glyph->textureRect.left);
+            const float v1 = static_cast<float>(glyph->textureRect.top);
+            const float u2 = static_cast<float>(glyph->textureRect.left + glyph->textureRect.width);
+            const float v2 = static_cast<float>(glyph->textureRect.top + glyph->textureRect.height);
+
+            vertices.append(Vertex(Vector2f(left, top), color, Vector2f(u1, v1)));
+            vertices.append(Vertex(Vector2f(right, top), color, Vector2f(u2, v1)));
+            vertices.append(Vertex(Vector2f(right, bottom), color, Vector2f(u2, v2)));
+            vertices.append(Vertex(Vector2f(left, bottom), color, Vector2f(u1, v2)));
+        }
+
+        x += glyph->advance;
+    }
+}
+
+void HudText::UpdateBounds()
+{
+    bounds = FloatRect();
+
+    if (!atlas || string.isEmpty())
+    {
+        return;
+    }
+
+    const float baseline = static_cast<float>(characterSize);
+    float minX = baseline;
+    float minY = baseline;
+    float maxX = 0.f;
+    float maxY = 0.f;
+    float x = 0.f;
+
+    for (const Uint32 character : string)
+    {
+        const GlyphAtlas::Glyph* glyph = atlas->Find(character, characterSize);
+
+        if (!glyph)
+        {
+            continue;
+        }
+
+        // A space only extends the width
+        if (glyph->textureRect.width == 0)
+        {
+            minX = min(minX, x);
+            minY = min(minY, baseline);
+            x += glyph->advance;
+            maxX = max(maxX, x);
+            maxY = max(maxY, baseline);
+            continue;
+        }
+
+        minX = min(minX, x + glyph->bounds.left);
+        maxX = max(maxX, x + glyph->bounds.left + glyph->bounds.width);
+        minY = min(minY, baseline + glyph->bounds.top);
+        maxY = max(maxY, baseline + glyph->bounds.top + glyph->bounds.height);
+        x += glyph->advance;
+    }
+
+    bounds = FloatRect(minX, minY, maxX - minX, maxY - minY);
+}
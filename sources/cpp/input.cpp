@@ -33,6 +33,10 @@ Input::Input()
     button.S = false;
     button.escape = false;
     button.space = false;
+    button.F3 = false;
+    button.F4 = false;
+    button.F5 = false;
+    button.F6 = false;
 }
 
 // Return the button
@@ -73,6 +77,18 @@ void Input::InputHandler(const Event& event, RenderWindow& window)
         case Keyboard::Space:
             button.space = true;
             break;
+        case Keyboard::F3:
+            button.F3 = true;
+            break;
+        case Keyboard::F4:
+            button.F4 = true;
+            break;
+        case Keyboard::F5:
+            button.F5 = true;
+            break;
+        case Keyboard::F6:
+            button.F6 = true;
+            break;
         default:
             break;
         }
@@ -99,6 +115,18 @@ void Input::InputHandler(const Event& event, RenderWindow& window)
         case Keyboard::Space:
             button.space = false;
             break;
+        case Keyboard::F3:
+            button.F3 = false;
+            break;
+        case Keyboard::F4:
+            button.F4 = false;
+            break;
+        case Keyboard::F5:
+            button.F5 = false;
+            break;
+        case Keyboard::F6:
+            button.F6 = false;
+            break;
         default:
             break;
         }
@@ -107,7 +135,11 @@ void Input::InputHandler(const Event& event, RenderWindow& window)
 
 void Input::ResetButtons()
 {
-    // Only reset the escape button and the space bar to allow repeated actions for other buttons
+    // Only reset the escape button, the space bar and the function keys to allow repeated actions for other buttons
     button.escape = false;
     button.space = false;
+    button.F3 = false;
+    button.F4 = false;
+    button.F5 = false;
+    button.F6 = false;
 }
@@ -0,0 +1,335 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "loadgen.h"
+
+#include "settings.h"
+#include <iostream>
+
+#ifdef __linux__
+
+#include "protocol.h"
+#include "server.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// Simulated player : joins a match and follows the ball with its racket
+struct LoadClient
+{
+    int socket;
+    bool joined;
+    Player side;
+    uint32_t tick;
+    Simulation::State state;
+};
+
+// Clients of one thread, with their event loop
+class LoadThread
+{
+public:
+    explicit LoadThread(unsigned short port) : target(0), states(0), port(port), running(true)
+    {
+        epoll = epoll_create1(0);
+        timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+
+        // Inputs are sent at the tick rate of the server
+        itimerspec period{};
+        period.it_interval.tv_nsec = 1000000000L / SERVER_TICK_RATE;
+        period.it_value = period.it_interval;
+        timerfd_settime(timer, 0, &period, nullptr);
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, timer, &event);
+
+        loop = thread(&LoadThread::Run, this);
+    }
+
+    ~LoadThread()
+    {
+        running = false;
+        loop.join();
+
+        unsigned char packet[MAX_PACKET_SIZE];
+        for (const unique_ptr<LoadClient>& client : clients)
+        {
+            send(client->socket, packet, WriteLeave(packet), 0);
+            close(client->socket);
+        }
+
+        close(timer);
+        close(epoll);
+    }
+
+    // Number of clients wanted, created by the thread itself
+    atomic<unsigned int> target;
+    // States received by all the clients
+    atomic<unsigned long long> states;
+
+private:
+    unsigned short port;
+    int epoll;
+    int timer;
+    vector<unique_ptr<LoadClient>> clients;
+    atomic<bool> running;
+    thread loop;
+
+    void AddClient()
+    {
+        unique_ptr<LoadClient> client = make_unique<LoadClient>();
+        client->socket = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+        client->joined = false;
+        client->tick = 0;
+        client->state = {};
+
+        // Connected so only the server can send to it
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        connect(client->socket, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = client.get();
+        epoll_ctl(epoll, EPOLL_CTL_ADD, client->socket, &event);
+
+        clients.push_back(move(client));
+    }
+
+    void SendInputs()
+    {
+        unsigned char packet[MAX_PACKET_SIZE];
+
+        for (const unique_ptr<LoadClient>& client : clients)
+        {
+            if (!client->joined)
+            {
+                send(client->socket, packet, WriteJoin(packet), 0);
+                continue;
+            }
+
+            // Follow the ball
+            const Simulation::State& state = client->state;
+            const float racketY = client->side == PlayerLeft ? state.racketLY : state.racketRY;
+            const float ballY = state.ballPosition.y + BALL_RADIUS;
+            const float middle = racketY + RACKET_L_HEIGHT / 2.f;
+
+            Input::Button button{};
+            (client->side == PlayerLeft ? button.Z : button.up) = ballY < middle - RACKET_L_SPEED;
+            (client->side == PlayerLeft ? button.S : button.down) = ballY > middle + RACKET_L_SPEED;
+
+            send(client->socket, packet, WriteInput(packet, client->tick, button), 0);
+        }
+    }
+
+    void Receive(LoadClient& client)
+    {
+        unsigned char packet[MAX_PACKET_SIZE];
+        unsigned long long received = 0;
+
+        while (true)
+        {
+            const ssize_t size = recv(client.socket, packet, sizeof(packet), 0);
+
+            if (size <= 0)
+            {
+                break;
+            }
+
+            uint32_t match;
+            if (ReadState(packet, size, client.tick, client.state))
+            {
+                received++;
+            }
+            else if (ReadWelcome(packet, size, match, client.side))
+            {
+                client.joined = true;
+            }
+        }
+
+        states.fetch_add(received, memory_order_relaxed);
+    }
+
+    void Run()
+    {
+        epoll_event events[256];
+
+        while (running)
+        {
+            const int count = epoll_wait(epoll, events, 256, 100);
+
+            for (int index = 0; index < count; index++)
+            {
+                if (events[index].data.ptr)
+                {
+                    Receive(*static_cast<LoadClient*>(events[index].data.ptr));
+                    continue;
+                }
+
+                unsigned long long expirations;
+                if (read(timer, &expirations, sizeof(expirations)) != sizeof(expirations))
+                {
+                    continue;
+                }
+
+                while (clients.size() < target.load(memory_order_relaxed))
+                {
+                    AddClient();
+                }
+
+                SendInputs();
+            }
+        }
+    }
+};
+
+int RunLoadGen(int argc, char* argv[])
+{
+    const unsigned int maxMatches = argc > 2 ? static_cast<unsigned int>(stoul(argv[2])) : LOADGEN_MAX_MATCHES;
+    const unsigned int cores = max(1u, thread::hardware_concurrency());
+    const unsigned int workers = argc > 3 ? static_cast<unsigned int>(stoul(argv[3])) : max(1u, cores / 2);
+    const unsigned int threadCount = argc > 4 ? static_cast<unsigned int>(stoul(argv[4])) : max(1u, cores - workers);
+
+    // One socket per client
+    rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    const unsigned int fileLimit = static_cast<unsigned int>(min<rlim_t>(limit.rlim_cur, 1u << 30));
+    const unsigned int matchLimit = min(maxMatches, (fileLimit - 64) / 2);
+
+    GameServer server;
+    if (!server.Start(SERVER_PORT, workers))
+    {
+        return 1;
+    }
+
+    vector<unique_ptr<LoadThread>> threads;
+    for (unsigned int index = 0; index < threadCount; index++)
+    {
+        threads.push_back(make_unique<LoadThread>(SERVER_PORT));
+    }
+
+    const double tickPeriod = 1e6 / SERVER_TICK_RATE;
+    unsigned int sustained = 0;
+    Histogram sustainedHistogram;
+
+    cout << "Server workers: " << workers << ", client threads: " << threadCount << ", tick rate: " << SERVER_TICK_RATE << " Hz\n";
+    cout << "   matches  clients   ticks/s  states/s per match  late ticks  tick p50 us  tick p99 us\n";
+
+    for (unsigned int matches = min(LOADGEN_STEP, matchLimit); matches <= matchLimit; matches += LOADGEN_STEP)
+    {
+        for (unsigned int index = 0; index < threadCount; index++)
+        {
+            // Two clients per match, but SO_REUSEPORT spreads them over the workers by address,
+            // so each worker can keep one client waiting for an opponent
+            threads[index]->target = (matches / threadCount + (index < matches % threadCount ? 1 : 0)) * 2;
+        }
+
+        // Let the new clients join before measuring
+        this_thread::sleep_for(chrono::duration<float>(LOADGEN_STEP_DURATION / 3.f));
+        server.CollectStats();
+        unsigned long long statesBefore = 0;
+        for (const unique_ptr<LoadThread>& loadThread : threads)
+        {
+            statesBefore += loadThread->states.load();
+        }
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+        this_thread::sleep_for(chrono::duration<float>(LOADGEN_STEP_DURATION * 2.f / 3.f));
+
+        const GameServer::Stats stats = server.CollectStats();
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        unsigned long long statesAfter = 0;
+        for (const unique_ptr<LoadThread>& loadThread : threads)
+        {
+            statesAfter += loadThread->states.load();
+        }
+
+        const double tickRate = static_cast<double>(stats.ticks) / seconds / stats.workers;
+        const double stateRate = static_cast<double>(statesAfter - statesBefore) / seconds / (2. * max(1u, stats.matches));
+        const double p99 = stats.tickHistogram.GetPercentile(99.);
+
+        char line[200];
+        snprintf(line, sizeof(line), "%10u %8u %9.1f %19.1f %11llu %12.1f %12.1f", stats.matches, stats.clients, tickRate, stateRate,
+            stats.lateTicks, stats.tickHistogram.GetPercentile(50.), p99);
+        cout << line << '\n';
+
+        // Every client must have joined and get its state at the tick rate, and a tick must fit in its period.
+        // A worker with an odd number of clients has one match waiting for its second client
+        if (stats.clients < matches * 2 || stats.matches + stats.workers < matches || stateRate < SERVER_TICK_RATE * 0.95 || tickRate < SERVER_TICK_RATE * 0.95 || p99 > tickPeriod)
+        {
+            break;
+        }
+
+        sustained = matches;
+        sustainedHistogram = stats.tickHistogram;
+
+        if (matches + LOADGEN_STEP > matchLimit && matches < matchLimit)
+        {
+            matches = matchLimit - LOADGEN_STEP;
+        }
+    }
+
+    threads.clear();
+    server.Stop();
+
+    cout << "\nMax concurrent matches at " << SERVER_TICK_RATE << " Hz: " << sustained;
+    if (sustained == matchLimit)
+    {
+        cout << " (limit of the test)";
+    }
+    cout << '\n';
+
+    if (sustained > 0)
+    {
+        sustainedHistogram.Report("Tick", cout);
+    }
+
+    return 0;
+}
+
+#else
+
+int RunLoadGen(int, char*[])
+{
+    cout << "The load generator needs Linux (epoll)\n";
+    return 1;
+}
+
+#endif
@@ -22,7 +22,10 @@
     SOFTWARE.
 */
 
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <numbers>
 #include <random>
 
 #include <SFML/Audio.hpp>
@@ -35,66 +38,224 @@
 
 using namespace std;
 
-int main()
+int main(int argc, char* argv[])
 {
+    // Headless AI vs AI matches
+    if (argc > 2 && string(argv[1]) == "--batch")
+    {
+        bool search = false;
+        string histogramFile;
+
+        for (int index = 3; index < argc; index++)
+        {
+            if (string(argv[index]) == "search")
+            {
+                search = true;
+            }
+            else if (string(argv[index]) == "--histogram" && index + 1 < argc)
+            {
+                histogramFile = argv[++index];
+            }
+        }
+
+        return RunBatch(static_cast<unsigned int>(stoul(argv[2])), search, histogramFile);
+    }
+
+    // Percentiles of histograms saved by several runs
+    if (argc > 2 && string(argv[1]) == "--histogram-merge")
+    {
+        return RunHistogramMerge(argc, argv);
+    }
+
+    // Learned policy playing against itself
+    if (argc > 4 && string(argv[1]) == "--policy")
+    {
+        return RunPolicy(argv[2], static_cast<unsigned int>(stoul(argv[3])), static_cast<unsigned int>(stoul(argv[4])));
+    }
+
+    // Reinforcement learning environment throughput
+    if (argc > 3 && string(argv[1]) == "--vecenv")
+    {
+        return RunVecEnv(static_cast<unsigned int>(stoul(argv[2])), static_cast<unsigned int>(stoul(argv[3])), argc > 4 ? static_cast<unsigned int>(stoul(argv[4])) : 0);
+    }
+
+    // Replays the same inputs on several simulations and compares the state of each tick
+    if (argc > 1 && (string(argv[1]) == "--determinism" || string(argv[1]) == "--determinism-record" || string(argv[1]) == "--determinism-verify"))
+    {
+        return RunDeterminism(argc, argv);
+    }
+
+    // Headless server hosting many network matches
+    if (argc > 1 && string(argv[1]) == "--server")
+    {
+        return RunServer(argc, argv);
+    }
+
+    // Simulated clients added until the server cannot keep its tick rate
+    if (argc > 1 && string(argv[1]) == "--loadgen")
+    {
+        return RunLoadGen(argc, argv);
+    }
+
+    // Streams a match to spectators
+    if (argc > 1 && string(argv[1]) == "--relay")
+    {
+        return RunRelay(argc, argv);
+    }
+
+    // Spectators per core of the relay
+    if (argc > 1 && string(argv[1]) == "--relay-bench")
+    {
+        return RunRelayBench(argc, argv);
+    }
+
+    // Round trips of the network codec on random states
+    if (argc > 1 && string(argv[1]) == "--codec-fuzz")
+    {
+        return RunCodecFuzz(argc, argv);
+    }
+
+    // Packs the assets into one archive, run after each build
+    if (argc > 1 && string(argv[1]) == "--pack-assets")
+    {
+        return RunPackAssets(argc, argv);
+    }
+
+    // Jitter of the frame pacing modes
+    if (argc > 1 && string(argv[1]) == "--pacing")
+    {
+        return RunPacing(argc, argv);
+    }
+
+    // Microbenchmarks of the hot functions
+    if (argc > 1 && string(argv[1]) == "--bench")
+    {
+        return RunBench(argc, argv);
+    }
+
+    // Comparison of the benchmarks with the baseline of the machine
+    if (argc > 1 && string(argv[1]) == "--bench-compare")
+    {
+        return RunBenchCompare(argc, argv);
+    }
+
+    // Long AI vs AI run without frame limit, to find leaks and slowdowns
+    if (argc > 1 && string(argv[1]) == "--soak")
+    {
+        const float minutes = argc > 2 ? stof(argv[2]) : SOAK_DURATION / 60.f;
+        soakTest = new Soak(minutes * 60.f, argc > 3 ? stof(argv[3]) : SOAK_INTERVAL);
+    }
+
+    Trace::Enable(TRACE_ENABLED);
+    Trace::SetThreadName("Main");
+
+    if (METRICS_ENABLED)
+    {
+        Metrics::Start(METRICS_PORT);
+    }
+
     // Render window
-    window = new RenderWindow(VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), GAME_TITLE);
+    {
+        Trace::Span span("Create window");
+        window = new RenderWindow(VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), GAME_TITLE, WINDOW_RESIZABLE ? Style::Default : Style::Titlebar | Style::Close);
+
+        if (!viewport.Resize(window->getSize()))
+        {
+            cout << "RENDER TEXTURE ERROR\n";
+        }
+    }
     Event event;
     Texture texture;
     Font font;
 
-    // Load the font
-    if (!font.loadFromFile(font_file))
+    // Frame rate limit, the soak test runs as fast as possible
+    pacer.SetFrameRate(soakTest ? 0 : FRAME_LIMIT);
+    window->setVerticalSyncEnabled(!soakTest && pacer.GetMode() == FramePacer::VerticalSync);
+
+    policy = new Policy();
+
+    // One mapping for all the assets, the loose files are used if there is no archive
     {
-        cout << "FONT LOADING ERROR\n";
-        window->close();
+        Trace::Span span("Archive::Open");
+
+        if (!assetArchive.Open(GetExecutableDirectory() + ASSET_ARCHIVE) && !assetArchive.Open(ASSET_ARCHIVE))
+        {
+            cout << "No asset archive, loading the files of " << assets_dir << "\n";
+        }
     }
 
-    // Load the racket sound effect
-    if (!LoadSound(racketBuffer, racketSoundEffect))
+    // Load the assets at the same time on worker threads while the loading screen is shown
     {
-        cout << "SOUND LOADING ERROR\n";
+        AssetLoader assets(ASSET_LOAD_THREADS);
+
+        future<bool> fontLoaded = assets.Load("LoadFont", [&font] { return LoadFont(font, assetArchive, font_file); });
+        future<bool> policyLoaded = assets.Load("Policy::LoadFromFile", [] { return CPU_POLICY_FILE.empty() || policy->LoadFromFile(CPU_POLICY_FILE); });
+
+        const double firstFrame = ShowLoadingScreen(assets);
+        const double loaded = chrono::duration<double, milli>(chrono::steady_clock::now() - startupTime).count();
+
+        if (!fontLoaded.get())
+        {
+            cout << "FONT LOADING ERROR\n";
+            window->close();
+        }
+
+        if (!policyLoaded.get())
+        {
+            cout << "POLICY LOADING ERROR\n";
+        }
+
+        ReportStartup(assets, firstFrame, loaded);
     }
 
-    // Load the wall sound effect
-    if (!LoadSound(wallBuffer, wallSoundEffect))
+    // Generate the sound effects
     {
-        cout << "SOUND LOADING ERROR\n";
+        Trace::Span span("Synth::Generate");
+
+        if (!Synth::Generate(RACKET_SOUND_PATCH, SYNTH_SAMPLE_RATE, racketBuffer) || !Synth::Generate(WALL_SOUND_PATCH, SYNTH_SAMPLE_RATE, wallBuffer))
+        {
+            cout << "SOUND GENERATION ERROR\n";
+        }
     }
 
     // Set sound properties
-    Sound racketSound, wallSound;
-    racketSound.setBuffer(racketBuffer);
-    wallSound.setBuffer(wallBuffer);
+    VoicePool voicePool(SOUND_VOICES);
+    const unsigned int racketSound = voicePool.AddEffect(racketBuffer, RACKET_SOUND_VOLUME, RACKET_SOUND_PRIORITY, RACKET_SOUND_MIN_INTERVAL);
+    const unsigned int wallSound = voicePool.AddEffect(wallBuffer, WALL_SOUND_VOLUME, WALL_SOUND_PRIORITY, WALL_SOUND_MIN_INTERVAL);
 
-    racketSound.setVolume(RACKET_SOUND_VOLUME);
-    wallSound.setVolume(WALL_SOUND_VOLUME);
+    // Init the text
+    // Rasterize every glyph of the texts now, so none is rasterized during the game
+    {
+        Trace::Span span("GlyphAtlas::Build");
 
-    // Frame rate limit
-    window->setFramerateLimit(FRAME_LIMIT);
+        hudAtlas.Add(SCORE_FONT_SIZE, "0123456789");
+        hudAtlas.Add(fontSizeWinner, TEXT_WINNER_L + TEXT_WINNER_R);
+        hudAtlas.Add(TEXT_REPLAY_FONT_SIZE, TEXT_REPLAY);
+        hudAtlas.Add(TEXT_PAUSE_FONT_SIZE, TEXT_PAUSE);
 
-    // Init the text
-    textScoreL = Text("0", font);
-    textScoreR = Text("0", font);
+        if (!hudAtlas.Build(font))
+        {
+            cout << "GLYPH ATLAS ERROR\n";
+        }
+    }
+
+    textScoreL = HudText("0", hudAtlas, SCORE_FONT_SIZE);
+    textScoreR = HudText("0", hudAtlas, SCORE_FONT_SIZE);
 
-    textWinner = Text("", font);
-    textWinner.setCharacterSize(fontSizeWinner);
+    textWinner = HudText("", hudAtlas, fontSizeWinner);
 
-    textReplay = Text("", font);
-    textReplay.setCharacterSize(TEXT_REPLAY_FONT_SIZE);
-    textReplay.setFillColor(TEXT_REPLAY_COLOR);
+    textReplay = HudText("", hudAtlas, TEXT_REPLAY_FONT_SIZE);
+    textReplay.SetFillColor(TEXT_REPLAY_COLOR);
 
-    textPause = Text("", font);
-    textPause.setCharacterSize(TEXT_PAUSE_FONT_SIZE);
-    textPause.setFillColor(TEXT_PAUSE_COLOR);
+    textPause = HudText("", hudAtlas, TEXT_PAUSE_FONT_SIZE);
+    textPause.SetFillColor(TEXT_PAUSE_COLOR);
 
-    textScoreL.setCharacterSize(SCORE_FONT_SIZE);
-    textScoreR.setCharacterSize(SCORE_FONT_SIZE);
-    textScoreL.setFillColor(PLAYER_L_COLOR);
-    textScoreR.setFillColor(PLAYER_R_COLOR);
+    textScoreL.SetFillColor(PLAYER_L_COLOR);
+    textScoreR.SetFillColor(PLAYER_R_COLOR);
 
-    textScoreL.setPosition(14 - textScoreL.getLocalBounds().width / 2.f, WINDOW_HEIGHT / 2.f - textScoreL.getLocalBounds().height / 2.f);
-    textScoreR.setPosition(WINDOW_WIDTH - 20 - textScoreR.getLocalBounds().width / 2.f, WINDOW_HEIGHT / 2.f - textScoreR.getLocalBounds().height / 2.f);
+    textScoreL.SetPosition(14 - textScoreL.GetLocalBounds().width / 2.f, WINDOW_HEIGHT / 2.f - textScoreL.GetLocalBounds().height / 2.f);
+    textScoreR.SetPosition(WINDOW_WIDTH - 20 - textScoreR.GetLocalBounds().width / 2.f, WINDOW_HEIGHT / 2.f - textScoreR.GetLocalBounds().height / 2.f);
+    BuildHud();
 
 
     // Init the rackets
@@ -106,374 +267,617 @@ int main()
 
     input = new Input();
 
-    // Throws the ball depending on who starts
-    switch (DEFAULT_PLAYER)
+    cpuL = new AI(PlayerLeft, CPU_REACTION_DELAY, CPU_AIM_ERROR, random_device()());
+    cpuR = new AI(PlayerRight, CPU_REACTION_DELAY, CPU_AIM_ERROR, random_device()());
+
+    if (CPU_SEARCH)
     {
-    case PlayerLeft:
-        currentDirection = Vector2f(-1.f, 0.f);
-        break;
-    case PlayerRight:
-        currentDirection = Vector2f(1.f, 0.f);
-        break;
+        searchPool = new ThreadPool();
+        searchL = new SearchAI(PlayerLeft, *searchPool, SEARCH_BUDGET_MS, random_device()());
+        searchR = new SearchAI(PlayerRight, *searchPool, SEARCH_BUDGET_MS, random_device()());
     }
 
+    profiler = new Profiler(font, PROFILER_HISTORY);
+
+    // Consumers of the events of the game, each reads its queue at its own point of the frame
+    const unsigned int audioEvents = events.Subscribe();
+    const unsigned int hudEvents = events.Subscribe();
+    const unsigned int telemetryEvents = events.Subscribe();
+    const unsigned int particleEvents = events.Subscribe();
+
+    chrono::steady_clock::time_point frameStart = chrono::steady_clock::now();
+
+    // Set when the image can't change before the next event
+    bool idle = false;
+
+    // The frames of the loading screen are not part of the jitter
+    pacer.Restart();
+    pacer.ResetStatistics();
+
     while (window->isOpen())
     {
-        // Events
-        while (window->pollEvent(event))
+        // Sleeps until an event, it is handled with the other events of the frame
+        const bool hasWaitedEvent = idle && window->waitEvent(event);
+
+        if (idle)
         {
-            input->InputHandler(event, *window);
+            pacer.Restart();
         }
 
-        // Update
-        CheckButton();
+        profiler->NextFrame();
 
-        // Collision effects
-        if (!win && !pause)
+        const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        const double frameTime = chrono::duration<double, micro>(now - frameStart).count();
+        frameStart = now;
+
+        // The time spent waiting for an event is not a frame time
+        if (!idle)
         {
-            if (Intersect() != LeftWindow && Intersect() != RightWindow)
+            frameHistogram.Record(frameTime);
+            Metrics::RecordFrame(frameTime);
+
+            // Lower resolution when the frames miss the frame rate, the soak test has no frame rate to keep
+            if (DYNAMIC_RENDER_SCALE && !soakTest && FRAME_LIMIT > 0 && viewport.Update(frameTime, 1e6 / FRAME_LIMIT))
             {
-                ball->Move(currentDirection, currentBallSpeed);
+                Trace::Counter("Render scale", viewport.GetScale());
             }
 
-            if (Intersect() == TopRacketL || Intersect() == TopRacketR || Intersect() == BottomRacketL || Intersect() == BottomRacketR)
+            if (soakTest)
             {
-                collisionCount++;
+                soakTest->RecordFrame(frameTime);
+            }
+        }
+
+        // Time of the first key press of the frame, to measure the latency until it is displayed
+        chrono::steady_clock::time_point inputTime;
+        bool hasInput = false;
 
-                racketSound.play();
+        // Events
+        {
+            Profiler::Scope scope(*profiler, Profiler::Events);
 
-                if (Intersect() == TopRacketL || Intersect() == BottomRacketL)
+            for (bool hasEvent = hasWaitedEvent; hasEvent || window->pollEvent(event); hasEvent = false)
+            {
+                if (event.type == Event::KeyPressed && !hasInput)
                 {
-                    ball->SetPosition(Vector2f(racketL->GetPosition().x + RACKET_L_WIDTH, ball->GetPosition().y));
+                    inputTime = chrono::steady_clock::now();
+                    hasInput = true;
                 }
-                else
+
+                if (event.type == Event::Resized)
                 {
-                    ball->SetPosition(Vector2f(racketR->GetPosition().x - BALL_RADIUS * 2, ball->GetPosition().y));
+                    viewport.Resize(Vector2u(event.size.width, event.size.height));
                 }
 
-                if (Intersect() == TopRacketL || Intersect() == TopRacketR)
+                input->InputHandler(event, *window);
+            }
+        }
+
+        // Update
+        Input::Button button;
+        {
+            Profiler::Scope scope(*profiler, Profiler::Buttons);
+            button = CheckButton();
+        }
+
+        // Rackets, ball and collision effects
+        if (!paused)
+        {
+            Profiler::Scope scope(*profiler, Profiler::Physics);
+            const bool playing = !simulation.GetState().win;
+            const chrono::steady_clock::time_point tickStart = chrono::steady_clock::now();
+
+            // The simulation resets the ball and the rally when a player scores, the point is shown with the previous state
+            const Simulation::State previous = simulation.GetState();
+            const Collision collision = simulation.Step(button);
+            const Simulation::State& state = simulation.GetState();
+            UpdateShapes();
+
+            // Once the match is won, only the rackets move
+            if (playing)
+            {
+                if (collision == TopRacketL || collision == TopRacketR || collision == BottomRacketL || collision == BottomRacketR)
                 {
-                    currentDirection = Vector2f(currentDirection.x * -1.f, 0.5f);
+                    PublishEvent(GameEvent::RacketHit, collision == TopRacketL || collision == BottomRacketL ? PlayerLeft : PlayerRight,
+                        collision == TopRacketL || collision == TopRacketR);
                 }
-                else
+                else if (collision == TopWindow || collision == BottomWindow)
                 {
-                    currentDirection = Vector2f(currentDirection.x * -1.f, -0.5f);
+                    PublishEvent(GameEvent::WallHit, PlayerLeft, collision == TopWindow);
+                }
+                else if (collision == LeftWindow)
+                {
+                    UpdateScore(PlayerRight, previous);
+                }
+                else if (collision == RightWindow)
+                {
+                    UpdateScore(PlayerLeft, previous);
                 }
 
-                // Increase the ball speed
-                currentBallSpeed = DEFAULT_BALL_SPEED + static_cast<float>(collisionCount) * BALL_SPEED_INCREASE_VALUE;
-            }
-            // If there is a collision between the ball and the window then bounce the ball
-            else if (Intersect() == TopWindow || Intersect() == BottomWindow)
-            {
-                wallSound.play();
+                // Let the computer players predict the new trajectory
+                cpuL->Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
+                cpuR->Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
 
-                if (Intersect() == TopWindow)
+                if (CPU_SEARCH)
                 {
-                    ball->SetPosition(Vector2f(ball->GetPosition().x, 0));
+                    searchL->Observe(collision, state);
+                    searchR->Observe(collision, state);
                 }
-                else
+
+                const double tickTime = chrono::duration<double, micro>(chrono::steady_clock::now() - tickStart).count();
+                tickHistogram.Record(tickTime);
+                Metrics::AddTick();
+
+                if (soakTest)
                 {
-                    ball->SetPosition(Vector2f(ball->GetPosition().x, WINDOW_HEIGHT - BALL_RADIUS * 2));
+                    soakTest->RecordTick(tickTime);
                 }
 
-                currentDirection = Vector2f(currentDirection.x, currentDirection.y * -1);
-            }
-            else if (Intersect() == LeftWindow)
-            {
-                UpdateScore(PlayerRight);
-            }
-            else if (Intersect() == RightWindow)
-            {
-                UpdateScore(PlayerLeft);
+                // Pause during 1.5 second after a point, after the tick time so it doesn't count as a tick.
+                // Skipped by the soak test.
+                if ((collision == LeftWindow || collision == RightWindow) && !soakTest)
+                {
+                    Trace::Span span("Serve pause");
+                    sleep(Time(seconds(1.5f)));
+                }
             }
         }
 
-        // Draw
-        window->clear();
-
-        window->draw(textScoreL);
-        window->draw(textScoreR);
-        window->draw(textWinner);
-        window->draw(textReplay);
-        window->draw(textPause);
-
-        window->draw(racketL->GetShape());
-        window->draw(racketR->GetShape());
-        window->draw(ball->GetShape());
+        // The sounds are played as soon as possible after the tick
+        events.Poll(audioEvents, [&voicePool, racketSound, wallSound](const GameEvent& gameEvent)
+        {
+            if (gameEvent.type == GameEvent::RacketHit || gameEvent.type == GameEvent::WallHit)
+            {
+                Trace::Span span("VoicePool::Play");
 
-        window->display();
+                if (voicePool.Play(gameEvent.type == GameEvent::RacketHit ? racketSound : wallSound, gameEvent.position.x, GetSoundPitch(gameEvent.ballSpeed)))
+                {
+                    Metrics::AddSoundPlay();
+                }
+            }
+        });
+        events.Poll(telemetryEvents, RecordEvent);
 
-        // Reset the escape button after processing it
-        input->ResetButtons();
-    }
-    return 0;
-}
+        Metrics::SetActiveMatches(simulation.GetState().win ? 0 : 1);
 
-// Check input
-void CheckButton()
-{
-    if (!pause)
-    {
-        // Left racket -> Move Up
-        if (input->GetButton().Z)
+        // The soak test replays each match until the end of the test
+        if (soakTest)
         {
-            // Limit the movement based on window
-            if (racketL->GetPosition().y > RACKET_L_MIN_POS_Y)
+            if (simulation.GetState().win)
             {
-                racketL->Move(1, RACKET_L_SPEED);
+                soakTest->AddMatch();
+                Replay();
             }
-        }
 
-        // Left racket -> Move Down
-        if (input->GetButton().S)
-        {
-            // Limit the movement based on window
-            if (racketL->GetPosition().y < RACKET_L_MAX_POS_Y)
+            if (!soakTest->Update())
             {
-                racketL->Move(-1, RACKET_L_SPEED);
+                window->close();
             }
         }
 
-        // Right racket -> Move Up
-        if (input->GetButton().up)
+        // Texts of the events of the frame
         {
-            // Limit the movement based on window
-            if (racketR->GetPosition().y > RACKET_R_MIN_POS_Y)
+            Profiler::Scope scope(*profiler, Profiler::Hud);
+            if (events.Poll(hudEvents, UpdateHud) > 0)
             {
-                racketR->Move(1, RACKET_R_SPEED);
+                BuildHud();
             }
         }
 
-        // Right racket -> Move Down
-        if (input->GetButton().down)
+        // Effects of the events of the frame, frozen during the pause
         {
-            // Limit the movement based on window
-            if (racketR->GetPosition().y < RACKET_R_MAX_POS_Y)
+            Profiler::Scope scope(*profiler, Profiler::Particles);
+            events.Poll(particleEvents, EmitParticles);
+
+            if (!paused)
             {
-                racketR->Move(-1, RACKET_R_SPEED);
+                // Long frames (loading, serve pause) are limited so the effects don't disappear at once
+                particles.Update(min(static_cast<float>(frameTime / 1e6), 0.1f));
             }
+            particles.BuildVertices();
         }
-    }
 
-    // Toggle pause if the space bar is pressed
-    if (input->GetButton().escape)
-    {
-        TogglePause();
-    }
+        // Draw
+        {
+            Profiler::Scope scope(*profiler, Profiler::Draw);
 
-    if (input->GetButton().space)
-    {
-        Replay();
-    }
-}
+            // The scene is drawn in logical coordinates, at the render scale
+            RenderTexture& scene = viewport.GetScene();
+            scene.clear();
 
-// Collision detection
-Collision Intersect()
-{
-    Collision collisionObject = None;
+            scene.draw(hudVertices, &hudAtlas.GetTexture());
 
-    // Get ball coordinate values
-    const float ballMinX = ball->GetPosition().x;
-    const float ballMinY = ball->GetPosition().y;
+            particles.Draw(scene);
 
-    const float ballMaxX = ballMinX + BALL_RADIUS * 2;
-    const float ballMaxY = ballMinY + BALL_RADIUS * 2;
+            scene.draw(racketL->GetShape());
+            scene.draw(racketR->GetShape());
+            scene.draw(ball->GetShape());
+        }
+
+        {
+            Profiler::Scope scope(*profiler, Profiler::Overlay);
+            profiler->DrawOverlay(viewport.GetScene());
+        }
 
-    // Get left racket coordinate values
-    const float racketLMinX = racketL->GetPosition().x;
-    const float racketLMinY = racketL->GetPosition().y;
+        // Scaling of the scene in the window
+        {
+            Profiler::Scope scope(*profiler, Profiler::Display);
+            viewport.GetScene().display();
+            window->clear();
+            viewport.Present(*window);
+            window->display();
+        }
 
-    const float racketLMaxX = racketLMinX + RACKET_L_WIDTH;
-    const float racketLMaxY = racketLMinY + RACKET_L_HEIGHT;
+        // Wait for the end of the frame
+        {
+            Profiler::Scope scope(*profiler, Profiler::Pacing);
+            pacer.Wait();
+        }
 
-    // Get right racket coordinate values
-    const float racketRMinX = racketR->GetPosition().x;
-    const float racketRMinY = racketR->GetPosition().y;
+        usage.SetState(paused ? UsageMeter::Paused : simulation.GetState().win ? UsageMeter::Won : UsageMeter::Playing);
+        usage.AddFrame();
 
-    const float racketRMaxX = racketRMinX + RACKET_R_WIDTH;
-    const float racketRMaxY = racketRMinY + RACKET_R_HEIGHT;
+        if (hasInput)
+        {
+            latencyHistogram.Record(chrono::duration<double, micro>(chrono::steady_clock::now() - inputTime).count());
+        }
 
-    /*
-    AABB algorithm (Axis-Aligned Bounding Boxes) in 2D
-    */
+        // Nothing moves during the pause (the particles are frozen), nor on the end screen once the particles are gone
+        // and no racket is held
+        const Input::Button held = input->GetButton();
+        idle = IDLE_RENDERING && !soakTest && !profiler->IsVisible()
+            && (paused || (simulation.GetState().win && particles.GetCount() == 0 && !held.Z && !held.S && !held.up && !held.down));
 
-    // Collision with left racket
-    if (ballMinX <= racketLMaxX && ballMaxX >= racketLMinX &&
-        ballMinY <= racketLMaxY && ballMaxY >= racketLMinY)
+        // Reset the escape button after processing it
+        input->ResetButtons();
+    }
+
+    if (Trace::IsEnabled())
     {
-        const float racketMiddleY = racketLMinY + RACKET_L_HEIGHT / 2.0f;
+        Trace::SaveToFile(TRACE_FILE);
+    }
 
-        if (ballMaxY >= racketMiddleY)
-        {
-            collisionObject = BottomRacketL;
-        }
-        else
-        {
-            collisionObject = TopRacketL;
-        }
+    ReportHistograms();
+    Metrics::Stop();
+
+    if (soakTest)
+    {
+        return soakTest->Report(SOAK_FILE);
     }
-    // Collision with right racket
-    else if (ballMinX <= racketRMaxX && ballMaxX >= racketRMinX &&
-        ballMinY <= racketRMaxY && ballMaxY >= racketRMinY)
+
+    return 0;
+}
+
+// Check input, returns the buttons of the rackets
+Input::Button CheckButton()
+{
+    Input::Button button = input->GetButton();
+    const bool win = simulation.GetState().win;
+
+    // The computer players replace the keyboard for their racket
+    if ((CPU_PLAYER_L || soakTest) && !win && !paused)
     {
-        const float racketMiddleY = racketRMinY + RACKET_R_HEIGHT / 2.0f;
+        CpuControl(button, PlayerLeft);
+    }
+    if ((CPU_PLAYER_R || soakTest) && !win && !paused)
+    {
+        CpuControl(button, PlayerRight);
+    }
 
-        if (ballMaxY >= racketMiddleY)
-        {
-            collisionObject = BottomRacketR;
-        }
-        else
-        {
-            collisionObject = TopRacketR;
-        }
+    // Toggle pause if the space bar is pressed
+    if (button.escape)
+    {
+        TogglePause();
     }
 
-    // Collision between the ball and the top of the window
-    else if (ballMinY <= 0)
+    if (button.space)
     {
-        collisionObject = TopWindow;
+        Replay();
     }
 
-    // Collision between the ball and the bottom of the window
-    else if (ballMaxY >= WINDOW_HEIGHT)
+    // Profiler overlay and export
+    if (button.F3)
     {
-        collisionObject = BottomWindow;
+        profiler->Toggle();
     }
 
-    // Collision between the ball and the right of the window
-    else if (ballMaxX >= WINDOW_WIDTH)
+    if (button.F4)
     {
-        collisionObject = RightWindow;
+        profiler->SaveToFile(PROFILER_FILE);
     }
 
-    // Collision between the ball and the left of the window
-    else if (ballMinX <= 0)
+    if (button.F5 && Trace::IsEnabled())
     {
-        collisionObject = LeftWindow;
+        Trace::SaveToFile(TRACE_FILE);
     }
 
-    return collisionObject;
+    if (button.F6)
+    {
+        ReportHistograms();
+    }
+
+    return button;
 }
 
-// Update the score if a player scores
-void UpdateScore(Player player)
+// Press the buttons of a racket played by the computer
+void CpuControl(Input::Button& button, Player side)
 {
-    switch (player)
+    if (policy->IsLoaded())
     {
-    case PlayerLeft:
-        scoreL++;
-        SetText(textScoreL, to_string(scoreL));
-        break;
-    case PlayerRight:
-        scoreR++;
-        SetText(textScoreR, to_string(scoreR));
-        break;
+        policy->Control(button, simulation.GetState(), side);
     }
-
-    // If the total score is even then throws the ball to the default player
-    if ((scoreR + scoreL) % 2 == 0)
+    else if (CPU_SEARCH)
     {
-        switch (DEFAULT_PLAYER)
-        {
-        case PlayerLeft:
-            currentDirection = Vector2f(-1.f, 0.f);
-            break;
-        case PlayerRight:
-            currentDirection = Vector2f(1.f, 0.f);
-            break;
-        }
+        (side == PlayerLeft ? searchL : searchR)->Control(button, simulation.GetState());
+    }
+    else if (side == PlayerLeft)
+    {
+        cpuL->Control(button, simulation.GetState().racketLY);
     }
     else
     {
-        switch (DEFAULT_PLAYER)
+        cpuR->Control(button, simulation.GetState().racketRY);
+    }
+}
+
+// Effects of a point, the simulation has already updated the score and reset the ball and the rackets
+void UpdateScore(Player player, const Simulation::State& previous)
+{
+    // Burst where the ball left, with the speed and the length of the rally that ended
+    Simulation::State point = previous;
+    point.scoreL = simulation.GetState().scoreL;
+    point.scoreR = simulation.GetState().scoreR;
+    PublishEvent(GameEvent::Scored, player, false, point);
+
+    // Check if there is a winner
+    if (simulation.GetState().win)
+    {
+        PublishEvent(GameEvent::MatchWon, player, false);
+    }
+}
+
+// Toggle pause function
+void TogglePause()
+{
+    paused = !paused;
+    PublishEvent(GameEvent::Paused, PlayerLeft, paused);
+}
+
+// Replay if the game is over and the space bar is pressed
+void Replay()
+{
+    if (simulation.GetState().win)
+    {
+        simulation.Reset();
+        UpdateShapes();
+
+        cpuL->Reset();
+        cpuR->Reset();
+
+        if (CPU_SEARCH)
         {
-        case PlayerLeft:
-            currentDirection = Vector2f(1.f, 0.f);
-            break;
-        case PlayerRight:
-            currentDirection = Vector2f(-1.f, 0.f);
-            break;
+            searchL->Reset();
+            searchR->Reset();
         }
-    }
 
-    // Update score text
-    textScoreL.setPosition(14 - textScoreL.getLocalBounds().width / 2, WINDOW_HEIGHT / 2.f - textScoreL.getLocalBounds().height / 2.f);
-    textScoreR.setPosition(WINDOW_WIDTH - 20 - textScoreR.getLocalBounds().width / 2, WINDOW_HEIGHT / 2.f - textScoreR.getLocalBounds().height / 2.f);
+        PublishEvent(GameEvent::MatchReset, DEFAULT_PLAYER, false);
+	}
+}
 
-    // Resets the racket to start with the rackets in the middle of the screen
-    racketL = new Racket(RACKET_L_WIDTH, RACKET_L_HEIGHT, DEFAULT_RACKET_L_POS_X, DEFAULT_RACKET_L_POS_Y, PLAYER_L_COLOR);
-    racketR = new Racket(RACKET_R_WIDTH, RACKET_R_HEIGHT, DEFAULT_RACKET_R_POS_X, DEFAULT_RACKET_R_POS_Y, PLAYER_R_COLOR);
+// Move the shapes to the ball and the rackets of the simulation
+void UpdateShapes()
+{
+    const Simulation::State& state = simulation.GetState();
 
-    // Check if there is a winner
-    Winner();
+    ball->SetPosition(state.ballPosition);
+    racketL->SetPosition(Vector2f(racketL->GetPosition().x, state.racketLY));
+    racketR->SetPosition(Vector2f(racketR->GetPosition().x, state.racketRY));
+}
 
-    // Reset the ball
-    ball = new Ball(BALL_RADIUS, DEFAULT_BALL_POS_X, DEFAULT_BALL_POS_Y, BALL_COLOR);
-    currentBallSpeed = DEFAULT_BALL_SPEED;
-    collisionCount = 0;
+// Publish an event with the current ball and scores
+void PublishEvent(GameEvent::Type type, Player player, bool top)
+{
+    PublishEvent(type, player, top, simulation.GetState());
+}
 
-    // Pause during 1.5 second
-    sleep(Time(seconds(1.5f)));
+// Publish an event with the ball and the scores of a state
+void PublishEvent(GameEvent::Type type, Player player, bool top, const Simulation::State& state)
+{
+    GameEvent gameEvent;
+    gameEvent.type = type;
+    gameEvent.player = player;
+    gameEvent.top = top;
+    gameEvent.position = state.ballPosition + Vector2f(BALL_RADIUS, BALL_RADIUS);
+    gameEvent.ballSpeed = state.ballSpeed;
+    gameEvent.scoreL = state.scoreL;
+    gameEvent.scoreR = state.scoreR;
+    gameEvent.rally = state.collisionCount;
+
+    if (!events.Publish(gameEvent))
+    {
+        Trace::Instant("Event dropped");
+    }
 }
 
-// Check if there is a winner
-void Winner()
+// Texts of the scores, the winner and the pause
+void UpdateHud(const GameEvent& gameEvent)
 {
-    // If a player has a score higher than the max score, the game is over
-    if (scoreL >= MAX_SCORE)
+    switch (gameEvent.type)
     {
-        win = true;
-        textWinner.setFillColor(PLAYER_L_COLOR);
-        SetText(textWinner, TEXT_WINNER_L);
+    case GameEvent::Scored:
+    case GameEvent::MatchReset:
+        SetText(textScoreL, to_string(gameEvent.scoreL));
+        SetText(textScoreR, to_string(gameEvent.scoreR));
+        textScoreL.SetPosition(14 - textScoreL.GetLocalBounds().width / 2, WINDOW_HEIGHT / 2.f - textScoreL.GetLocalBounds().height / 2.f);
+        textScoreR.SetPosition(WINDOW_WIDTH - 20 - textScoreR.GetLocalBounds().width / 2, WINDOW_HEIGHT / 2.f - textScoreR.GetLocalBounds().height / 2.f);
+
+        if (gameEvent.type == GameEvent::MatchReset)
+        {
+            SetText(textWinner, "");
+            SetText(textReplay, "");
+        }
+        break;
+    case GameEvent::MatchWon:
+        textWinner.SetFillColor(gameEvent.player == PlayerLeft ? PLAYER_L_COLOR : PLAYER_R_COLOR);
+        SetText(textWinner, gameEvent.player == PlayerLeft ? TEXT_WINNER_L : TEXT_WINNER_R);
         SetText(textReplay, TEXT_REPLAY);
+        textWinner.SetPosition(WINDOW_WIDTH / 2.f - textWinner.GetLocalBounds().width / 2.f, 24);
+        textReplay.SetPosition(WINDOW_WIDTH / 2.f - textReplay.GetLocalBounds().width / 2.f, 96);
+        break;
+    case GameEvent::Paused:
+        SetText(textPause, gameEvent.top ? TEXT_PAUSE : "");
+        break;
+    default:
+        break;
     }
-    else if (scoreR >= MAX_SCORE)
+}
+
+// Quads of all the texts, drawn with one call
+void BuildHud()
+{
+    hudVertices.clear();
+    textScoreL.Append(hudVertices);
+    textScoreR.Append(hudVertices);
+    textWinner.Append(hudVertices);
+    textReplay.Append(hudVertices);
+    textPause.Append(hudVertices);
+}
+
+// Counters of the metrics and instants of the trace
+void RecordEvent(const GameEvent& gameEvent)
+{
+    switch (gameEvent.type)
     {
-        win = true;
-        textWinner.setFillColor(PLAYER_R_COLOR);
-        SetText(textWinner, TEXT_WINNER_R);
-        SetText(textReplay, TEXT_REPLAY);
+    case GameEvent::RacketHit:
+        Metrics::AddRacketHit();
+        Trace::Instant("Racket hit");
+        Trace::Counter("Ball speed", gameEvent.ballSpeed);
+        break;
+    case GameEvent::WallHit:
+        Metrics::AddWallHit();
+        Trace::Instant("Wall hit");
+        break;
+    case GameEvent::Scored:
+        Metrics::EndRally(gameEvent.rally);
+        Trace::Instant("Score");
+        break;
+    case GameEvent::MatchWon:
+        Metrics::AddMatch();
+        break;
+    default:
+        break;
     }
+}
+
+// Bursts of the color of the player, away from the racket or the wall
+void EmitParticles(const GameEvent& gameEvent)
+{
+    const float pi = numbers::pi_v<float>;
+    const Color color = gameEvent.player == PlayerLeft ? PLAYER_L_COLOR : PLAYER_R_COLOR;
 
-    textWinner.setPosition(WINDOW_WIDTH / 2.f - textWinner.getLocalBounds().width / 2.f, 24);
-    textReplay.setPosition(WINDOW_WIDTH / 2.f - textReplay.getLocalBounds().width / 2.f, 96);
+    switch (gameEvent.type)
+    {
+    case GameEvent::RacketHit:
+        particles.Emit(gameEvent.position, color, RACKET_HIT_PARTICLES, gameEvent.player == PlayerLeft ? 0.f : pi, pi);
+        break;
+    case GameEvent::WallHit:
+        // The y axis goes down
+        particles.Emit(gameEvent.position, BALL_COLOR, WALL_HIT_PARTICLES, gameEvent.top ? pi / 2.f : -pi / 2.f, pi);
+        break;
+    case GameEvent::Scored:
+        particles.Emit(gameEvent.position, color, SCORE_PARTICLES, 0.f, 2.f * pi);
+        break;
+    case GameEvent::MatchReset:
+        particles.Clear();
+        break;
+    default:
+        break;
+    }
 }
 
-// Toggle pause function
-void TogglePause()
+// The sounds get higher as the ball speeds up
+float GetSoundPitch(float ballSpeed)
 {
-    pause = !pause;
-    SetText(textPause, pause ? TEXT_PAUSE : "");
+    return min(SOUND_MAX_PITCH, 1.f + SOUND_PITCH_SPEED * (ballSpeed / DEFAULT_BALL_SPEED - 1.f));
 }
 
-// Replay if the game is over and the space bar is pressed
-void Replay()
+// Print the percentiles of the frame time, the simulation time and the input latency
+void ReportHistograms()
 {
-    if (win)
+    frameHistogram.Report("Frame", cout);
+    tickHistogram.Report("Simulation", cout);
+    latencyHistogram.Report("Input", cout);
+    usage.Report(cout);
+    pacer.Report(cout);
+}
+
+// Draw the progress of the loading until every asset is loaded or the window is closed.
+// Returns the time from the start of the program to the first frame (in milliseconds).
+double ShowLoadingScreen(const AssetLoader& assets)
+{
+    RectangleShape frame(LOADING_BAR_SIZE);
+    frame.setFillColor(Color::Transparent);
+    frame.setOutlineColor(LOADING_BAR_COLOR);
+    frame.setOutlineThickness(1.f);
+    frame.setPosition(WINDOW_WIDTH / 2.f - LOADING_BAR_SIZE.x / 2.f, WINDOW_HEIGHT / 2.f - LOADING_BAR_SIZE.y / 2.f);
+
+    RectangleShape bar;
+    bar.setFillColor(LOADING_BAR_COLOR);
+    bar.setPosition(frame.getPosition());
+
+    Event event;
+    double firstFrame = 0.0;
+
+    while (window->isOpen())
     {
-        win = false;
-        scoreL = 0;
-        scoreR = 0;
-        SetText(textWinner, "");
-        SetText(textReplay, "");
-        SetText(textScoreL, "0");
-        SetText(textScoreR, "0");
-        textScoreL.setPosition(14 - textScoreL.getLocalBounds().width / 2, WINDOW_HEIGHT / 2.f - textScoreL.getLocalBounds().height / 2.f);
-        textScoreR.setPosition(WINDOW_WIDTH - 20 - textScoreR.getLocalBounds().width / 2, WINDOW_HEIGHT / 2.f - textScoreR.getLocalBounds().height / 2.f);
+        while (window->pollEvent(event))
+        {
+            if (event.type == Event::Closed)
+            {
+                window->close();
+            }
+            else if (event.type == Event::Resized)
+            {
+                viewport.Resize(Vector2u(event.size.width, event.size.height));
+            }
+        }
 
-        ball = new Ball(BALL_RADIUS, DEFAULT_BALL_POS_X, DEFAULT_BALL_POS_Y, BALL_COLOR);
+        // Read before drawing so the last frame shows a full bar
+        const bool done = assets.IsDone();
+        const float progress = static_cast<float>(assets.GetLoadedCount()) / static_cast<float>(max<size_t>(1, assets.GetAssetCount()));
+        bar.setSize(Vector2f(LOADING_BAR_SIZE.x * progress, LOADING_BAR_SIZE.y));
 
-        racketL = new Racket(RACKET_L_WIDTH, RACKET_L_HEIGHT, DEFAULT_RACKET_L_POS_X, DEFAULT_RACKET_L_POS_Y, PLAYER_L_COLOR);
-        racketR = new Racket(RACKET_R_WIDTH, RACKET_R_HEIGHT, DEFAULT_RACKET_R_POS_X, DEFAULT_RACKET_R_POS_Y, PLAYER_R_COLOR);
+        // Drawn directly in the letterbox, the scene texture is only used by the game
+        window->setView(viewport.GetLetterboxView());
+        window->clear();
+        window->draw(frame);
+        window->draw(bar);
+        window->display();
+        pacer.Wait();
 
-        switch (DEFAULT_PLAYER)
+        if (firstFrame == 0.0)
+        {
+            firstFrame = chrono::duration<double, milli>(chrono::steady_clock::now() - startupTime).count();
+            Trace::Instant("First frame");
+        }
+
+        if (done)
         {
-        case PlayerLeft:
-            currentDirection = Vector2f(-1.f, 0.f);
             break;
-        case PlayerRight:
-            currentDirection = Vector2f(1.f, 0.f);
         }
-	}
+    }
+    return firstFrame;
+}
+
+void ReportStartup(const AssetLoader& assets, double firstFrame, double loaded)
+{
+    cout << fixed << setprecision(1);
+    cout << "Startup : first frame " << firstFrame << " ms, loaded " << loaded << " ms\n";
+
+    for (const AssetLoader::Timing& timing : assets.GetTimings())
+    {
+        cout << "  " << left << setw(24) << timing.name << right << setw(8) << timing.start << " -> " << setw(8) << timing.end << " ms"
+            << (timing.loaded ? "" : " (error)") << "\n";
+    }
+    cout << defaultfloat;
 }
\ No newline at end of file
@@ -0,0 +1,309 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "metrics.h"
+
+#include "process.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <SFML/Network.hpp>
+
+using namespace sf;
+
+const double Metrics::FRAME_BUCKETS[FRAME_BUCKET_COUNT - 1]{ 0.001, 0.002, 0.004, 0.008, 0.0125, 0.0167, 0.02, 0.025, 0.0333, 0.05, 0.1, 0.25, 0.5, 1. };
+
+atomic<unsigned long long> Metrics::frameCounts[FRAME_BUCKET_COUNT];
+atomic<unsigned long long> Metrics::frames{ 0 };
+atomic<double> Metrics::frameSeconds{ 0. };
+atomic<unsigned long long> Metrics::ticks{ 0 };
+atomic<unsigned long long> Metrics::racketHits{ 0 };
+atomic<unsigned long long> Metrics::wallHits{ 0 };
+atomic<unsigned long long> Metrics::soundPlays{ 0 };
+atomic<unsigned long long> Metrics::rallies{ 0 };
+atomic<unsigned long long> Metrics::rallyHits{ 0 };
+atomic<unsigned int> Metrics::lastRally{ 0 };
+atomic<unsigned int> Metrics::longestRally{ 0 };
+atomic<unsigned long long> Metrics::matches{ 0 };
+atomic<unsigned int> Metrics::activeMatches{ 0 };
+
+atomic<bool> Metrics::running{ false };
+thread* Metrics::server{ nullptr };
+
+// Time waited for new connections before checking if the server is stopped
+const Time ACCEPT_TIMEOUT{ milliseconds(100) };
+// A client that doesn't send its request in time is dropped, so it can't block the server nor its stop
+const Time REQUEST_TIMEOUT{ milliseconds(500) };
+
+// The port is opened by the server thread, an error is printed if it is not available
+void Metrics::Start(unsigned short port)
+{
+    if (server)
+    {
+        return;
+    }
+
+    running = true;
+    server = new thread(Serve, port);
+}
+
+void Metrics::Stop()
+{
+    if (!server)
+    {
+        return;
+    }
+
+    running = false;
+    server->join();
+    delete server;
+    server = nullptr;
+}
+
+// Only the game thread writes the counters, relaxed increments are enough
+void Metrics::RecordFrame(double microseconds)
+{
+    const double seconds = microseconds / 1e6;
+    size_t bucket = 0;
+
+    while (bucket < FRAME_BUCKET_COUNT - 1 && seconds > FRAME_BUCKETS[bucket])
+    {
+        bucket++;
+    }
+
+    frameCounts[bucket].fetch_add(1, memory_order_relaxed);
+    frames.fetch_add(1, memory_order_relaxed);
+    frameSeconds.store(frameSeconds.load(memory_order_relaxed) + seconds, memory_order_relaxed);
+}
+
+void Metrics::AddTick()
+{
+    ticks.fetch_add(1, memory_order_relaxed);
+}
+
+void Metrics::AddRacketHit()
+{
+    racketHits.fetch_add(1, memory_order_relaxed);
+}
+
+void Metrics::AddWallHit()
+{
+    wallHits.fetch_add(1, memory_order_relaxed);
+}
+
+void Metrics::AddSoundPlay()
+{
+    soundPlays.fetch_add(1, memory_order_relaxed);
+}
+
+void Metrics::EndRally(unsigned int hits)
+{
+    rallies.fetch_add(1, memory_order_relaxed);
+    rallyHits.fetch_add(hits, memory_order_relaxed);
+    lastRally.store(hits, memory_order_relaxed);
+
+    if (hits > longestRally.load(memory_order_relaxed))
+    {
+        longestRally.store(hits, memory_order_relaxed);
+    }
+}
+
+void Metrics::AddMatch()
+{
+    matches.fetch_add(1, memory_order_relaxed);
+}
+
+void Metrics::SetActiveMatches(unsigned int count)
+{
+    activeMatches.store(count, memory_order_relaxed);
+}
+
+// Linear interpolation in the bucket, like histogram_quantile() of Prometheus
+double Metrics::GetFramePercentile(double percentile)
+{
+    unsigned long long counts[FRAME_BUCKET_COUNT];
+    unsigned long long total = 0;
+
+    for (size_t bucket = 0; bucket < FRAME_BUCKET_COUNT; bucket++)
+    {
+        counts[bucket] = frameCounts[bucket].load(memory_order_relaxed);
+        total += counts[bucket];
+    }
+
+    if (total == 0)
+    {
+        return 0.;
+    }
+
+    const double rank = percentile / 100. * static_cast<double>(total);
+    unsigned long long cumulated = 0;
+
+    for (size_t bucket = 0; bucket < FRAME_BUCKET_COUNT - 1; bucket++)
+    {
+        if (static_cast<double>(cumulated + counts[bucket]) >= rank)
+        {
+            const double lower = bucket == 0 ? 0. : FRAME_BUCKETS[bucket - 1];
+            return lower + (FRAME_BUCKETS[bucket] - lower) * (rank - static_cast<double>(cumulated)) / static_cast<double>(counts[bucket]);
+        }
+
+        cumulated += counts[bucket];
+    }
+
+    // In the +Inf bucket
+    return FRAME_BUCKETS[FRAME_BUCKET_COUNT - 2];
+}
+
+string Metrics::Format()
+{
+    ostringstream stream;
+
+    const auto metric = [&](const char* name, const char* type, const char* help, auto value)
+    {
+        stream << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n' << name << ' ' << value << '\n';
+    };
+
+    // Frame time histogram, the buckets are cumulative
+    stream << "# HELP pong_frame_seconds Time between two frames\n# TYPE pong_frame_seconds histogram\n";
+    unsigned long long cumulated = 0;
+    for (size_t bucket = 0; bucket < FRAME_BUCKET_COUNT; bucket++)
+    {
+        cumulated += frameCounts[bucket].load(memory_order_relaxed);
+        stream << "pong_frame_seconds_bucket{le=\"";
+        if (bucket < FRAME_BUCKET_COUNT - 1)
+        {
+            stream << FRAME_BUCKETS[bucket];
+        }
+        else
+        {
+            stream << "+Inf";
+        }
+        stream << "\"} " << cumulated << '\n';
+    }
+    stream << "pong_frame_seconds_sum " << frameSeconds.load(memory_order_relaxed) << '\n';
+    stream << "pong_frame_seconds_count " << cumulated << '\n';
+
+    stream << "# HELP pong_frame_seconds_percentile Frame time percentiles estimated from the buckets\n# TYPE pong_frame_seconds_percentile gauge\n";
+    for (double percentile : { 50., 90., 99. })
+    {
+        stream << "pong_frame_seconds_percentile{percentile=\"" << percentile << "\"} " << GetFramePercentile(percentile) << '\n';
+    }
+
+    metric("pong_ticks_total", "counter", "Simulated frames", ticks.load(memory_order_relaxed));
+    metric("pong_racket_hits_total", "counter", "Collisions between the ball and a racket", racketHits.load(memory_order_relaxed));
+    metric("pong_wall_hits_total", "counter", "Collisions between the ball and the top or the bottom of the window", wallHits.load(memory_order_relaxed));
+    metric("pong_sound_plays_total", "counter", "Sound effects played", soundPlays.load(memory_order_relaxed));
+    metric("pong_rallies_total", "counter", "Points scored", rallies.load(memory_order_relaxed));
+    metric("pong_rally_hits_total", "counter", "Racket hits of all the rallies, divide by pong_rallies_total for the mean length", rallyHits.load(memory_order_relaxed));
+    metric("pong_rally_length_last", "gauge", "Racket hits of the last rally", lastRally.load(memory_order_relaxed));
+    metric("pong_rally_length_max", "gauge", "Racket hits of the longest rally", longestRally.load(memory_order_relaxed));
+    metric("pong_matches_total", "counter", "Finished matches", matches.load(memory_order_relaxed));
+    metric("pong_active_matches", "gauge", "Matches in progress", activeMatches.load(memory_order_relaxed));
+
+    const ProcessStats stats = GetProcessStats();
+    if (ALLOCATIONS_COUNTED)
+    {
+        metric("pong_allocations_total", "counter", "Calls to operator new", stats.allocations);
+        metric("pong_live_allocations", "gauge", "Blocks allocated by operator new and not freed", stats.liveAllocations);
+        metric("pong_live_allocated_bytes", "gauge", "Bytes allocated by operator new and not freed", stats.liveBytes);
+    }
+    metric("process_resident_memory_bytes", "gauge", "Resident memory size in bytes", stats.resident);
+    metric("process_open_fds", "gauge", "Open handles", stats.handles);
+
+    return stream.str();
+}
+
+void Metrics::Serve(unsigned short port)
+{
+    TcpListener listener;
+
+    // Only reachable from this computer
+    if (listener.listen(port, IpAddress::LocalHost) != Socket::Done)
+    {
+        cout << "METRICS PORT " << port << " NOT AVAILABLE\n";
+        return;
+    }
+
+    SocketSelector selector;
+    selector.add(listener);
+
+    // Rate of the ticks between two scrapes
+    chrono::steady_clock::time_point lastScrape = chrono::steady_clock::now();
+    unsigned long long lastTicks = ticks.load(memory_order_relaxed);
+
+    while (running)
+    {
+        if (!selector.wait(ACCEPT_TIMEOUT))
+        {
+            continue;
+        }
+
+        TcpSocket client;
+        if (listener.accept(client) != Socket::Done)
+        {
+            continue;
+        }
+
+        SocketSelector clientSelector;
+        clientSelector.add(client);
+        if (!clientSelector.wait(REQUEST_TIMEOUT))
+        {
+            continue;
+        }
+
+        // The request line is enough, the headers are ignored
+        char request[1024];
+        size_t received = 0;
+        if (client.receive(request, sizeof(request) - 1, received) != Socket::Done)
+        {
+            continue;
+        }
+        request[received] = '\0';
+
+        string status = "200 OK";
+        string body;
+
+        if (string(request).rfind("GET /metrics", 0) == 0)
+        {
+            const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+            const unsigned long long currentTicks = ticks.load(memory_order_relaxed);
+            const double seconds = chrono::duration<double>(now - lastScrape).count();
+
+            body = Format();
+            body += "# HELP pong_ticks_per_second Simulated frames per second since the previous scrape\n# TYPE pong_ticks_per_second gauge\n";
+            body += "pong_ticks_per_second " + to_string(seconds > 0. ? static_cast<double>(currentTicks - lastTicks) / seconds : 0.) + '\n';
+
+            lastScrape = now;
+            lastTicks = currentTicks;
+        }
+        else
+        {
+            status = "404 Not Found";
+            body = "Not found, the metrics are on /metrics\n";
+        }
+
+        const string response = "HTTP/1.0 " + status + "\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " + to_string(body.size()) +
+            "\r\nConnection: close\r\n\r\n" + body;
+        client.send(response.data(), response.size());
+    }
+}
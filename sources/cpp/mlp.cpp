@@ -0,0 +1,214 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "mlp.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// Limits of the network files, checked before anything is allocated
+const uint32_t MAX_LAYERS{ 16 };
+const uint32_t MAX_LAYER_SIZE{ 4096 };
+
+// Constructor
+Mlp::Mlp()
+{
+}
+
+// Load the weights from file
+bool Mlp::LoadFromFile(const string& fileName)
+{
+    ifstream file(fileName, ios::binary);
+    uint32_t header[2] = {};
+
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != MAGIC || header[1] == 0 || header[1] > MAX_LAYERS)
+    {
+        cerr << "Error loading network file: " << fileName << "\n";
+        return false;
+    }
+
+    vector<uint32_t> sizes(header[1] + 1);
+
+    if (!file.read(reinterpret_cast<char*>(sizes.data()), sizes.size() * sizeof(uint32_t)))
+    {
+        cerr << "Error loading network file: " << fileName << "\n";
+        return false;
+    }
+
+    // The rest of the file must be exactly the weights and biases of the layers
+    unsigned long long parameterCount = 0;
+
+    for (size_t index = 0; index < sizes.size(); index++)
+    {
+        if (sizes[index] == 0 || sizes[index] > MAX_LAYER_SIZE)
+        {
+            cerr << "Error loading network file: " << fileName << "\n";
+            return false;
+        }
+
+        if (index > 0)
+        {
+            parameterCount += (static_cast<unsigned long long>(sizes[index - 1]) + 1) * sizes[index];
+        }
+    }
+
+    const streampos dataStart = file.tellg();
+    file.seekg(0, ios::end);
+    const streampos fileEnd = file.tellg();
+    file.seekg(dataStart);
+
+    if (dataStart < 0 || fileEnd < 0 || static_cast<unsigned long long>(fileEnd - dataStart) != parameterCount * sizeof(float))
+    {
+        cerr << "Error loading network file: " << fileName << "\n";
+        return false;
+    }
+
+    vector<Layer> loaded(header[1]);
+
+    for (size_t index = 0; index < loaded.size(); index++)
+    {
+        Layer& layer = loaded[index];
+        layer.inputSize = sizes[index];
+        layer.outputSize = sizes[index + 1];
+        layer.paddedSize = (layer.outputSize + LANES - 1) / LANES * LANES;
+
+        vector<float> weights(layer.outputSize * layer.inputSize);
+        layer.biases.assign(layer.paddedSize, 0.f);
+
+        if (!file.read(reinterpret_cast<char*>(weights.data()), weights.size() * sizeof(float)) ||
+            !file.read(reinterpret_cast<char*>(layer.biases.data()), layer.outputSize * sizeof(float)))
+        {
+            cerr << "Error loading network file: " << fileName << "\n";
+            return false;
+        }
+
+        layer.weights.assign(layer.inputSize * layer.paddedSize, 0.f);
+
+        for (size_t output = 0; output < layer.outputSize; output++)
+        {
+            for (size_t input = 0; input < layer.inputSize; input++)
+            {
+                layer.weights[input * layer.paddedSize + output] = weights[output * layer.inputSize + input];
+            }
+        }
+    }
+
+    layers = move(loaded);
+    return true;
+}
+
+size_t Mlp::GetInputSize() const
+{
+    return layers.empty() ? 0 : layers.front().inputSize;
+}
+
+size_t Mlp::GetOutputSize() const
+{
+    return layers.empty() ? 0 : layers.back().outputSize;
+}
+
+void Mlp::Evaluate(const float* inputs, float* outputs, size_t count)
+{
+    if (layers.empty())
+    {
+        return;
+    }
+
+    // The buffers only grow, so there is no allocation once the batch size is stable
+    size_t widest = 0;
+    for (const Layer& layer : layers)
+    {
+        widest = max(widest, layer.paddedSize);
+    }
+    if (bufferA.size() < widest * count)
+    {
+        bufferA.resize(widest * count);
+        bufferB.resize(widest * count);
+    }
+
+    const float* current = inputs;
+    size_t stride = GetInputSize();
+    float* next = bufferA.data();
+
+    for (size_t index = 0; index < layers.size(); index++)
+    {
+        const bool last = index + 1 == layers.size();
+        Forward(layers[index], current, stride, next, count, !last);
+
+        current = next;
+        stride = layers[index].paddedSize;
+        next = next == bufferA.data() ? bufferB.data() : bufferA.data();
+    }
+
+    for (size_t sample = 0; sample < count; sample++)
+    {
+        memcpy(outputs + sample * GetOutputSize(), current + sample * stride, GetOutputSize() * sizeof(float));
+    }
+}
+
+// outputs[sample][paddedSize] = inputs[sample] * weights + biases
+void Mlp::Forward(const Layer& layer, const float* inputs, size_t inputStride, float* outputs, size_t count, bool relu)
+{
+#if defined(SIMD_X86)
+    if (HasAvx2())
+    {
+        ForwardAvx2(layer, inputs, inputStride, outputs, count, relu);
+        return;
+    }
+#endif
+
+    // Portable version, same memory order so the compiler can vectorize the inner loop
+    const size_t padded = layer.paddedSize;
+
+    for (size_t sample = 0; sample < count; sample++)
+    {
+        const float* in = inputs + sample * inputStride;
+        float* out = outputs + sample * padded;
+
+        memcpy(out, layer.biases.data(), padded * sizeof(float));
+
+        for (size_t input = 0; input < layer.inputSize; input++)
+        {
+            const float value = in[input];
+            const float* weight = &layer.weights[input * padded];
+
+            for (size_t output = 0; output < padded; output++)
+            {
+                out[output] += value * weight[output];
+            }
+        }
+
+        if (relu)
+        {
+            for (size_t output = 0; output < padded; output++)
+            {
+                out[output] = max(out[output], 0.f);
+            }
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include "mlp.h"
+#include "simd.h"
+
+#if defined(SIMD_X86)
+
+#include <immintrin.h>
+
+// Number of samples computed together
+const size_t BLOCK{ 4 };
+
+// Forward by blocks of BLOCK samples and LANES outputs, this file is the only one built with AVX2
+SIMD_TARGET_AVX2 void Mlp::ForwardAvx2(const Layer& layer, const float* inputs, size_t inputStride, float* outputs, size_t count, bool relu)
+{
+    const size_t padded = layer.paddedSize;
+    size_t sample = 0;
+
+    const __m256 zero = _mm256_setzero_ps();
+
+    for (; sample + BLOCK <= count; sample += BLOCK)
+    {
+        const float* in0 = inputs + (sample + 0) * inputStride;
+        const float* in1 = inputs + (sample + 1) * inputStride;
+        const float* in2 = inputs + (sample + 2) * inputStride;
+        const float* in3 = inputs + (sample + 3) * inputStride;
+
+        for (size_t output = 0; output < padded; output += LANES)
+        {
+            const __m256 bias = _mm256_loadu_ps(&layer.biases[output]);
+            __m256 sum0 = bias;
+            __m256 sum1 = bias;
+            __m256 sum2 = bias;
+            __m256 sum3 = bias;
+
+            // Each weight row is loaded once for the four samples
+            for (size_t input = 0; input < layer.inputSize; input++)
+            {
+                const __m256 weight = _mm256_loadu_ps(&layer.weights[input * padded + output]);
+                sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_set1_ps(in0[input]), weight));
+                sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_set1_ps(in1[input]), weight));
+                sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(_mm256_set1_ps(in2[input]), weight));
+                sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(_mm256_set1_ps(in3[input]), weight));
+            }
+
+            if (relu)
+            {
+                sum0 = _mm256_max_ps(sum0, zero);
+                sum1 = _mm256_max_ps(sum1, zero);
+                sum2 = _mm256_max_ps(sum2, zero);
+                sum3 = _mm256_max_ps(sum3, zero);
+            }
+
+            _mm256_storeu_ps(outputs + (sample + 0) * padded + output, sum0);
+            _mm256_storeu_ps(outputs + (sample + 1) * padded + output, sum1);
+            _mm256_storeu_ps(outputs + (sample + 2) * padded + output, sum2);
+            _mm256_storeu_ps(outputs + (sample + 3) * padded + output, sum3);
+        }
+    }
+
+    // Remaining samples, one at a time (GEMV)
+    for (; sample < count; sample++)
+    {
+        const float* in = inputs + sample * inputStride;
+
+        for (size_t output = 0; output < padded; output += LANES)
+        {
+            __m256 sum = _mm256_loadu_ps(&layer.biases[output]);
+
+            for (size_t input = 0; input < layer.inputSize; input++)
+            {
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(in[input]), _mm256_loadu_ps(&layer.weights[input * padded + output])));
+            }
+
+            if (relu)
+            {
+                sum = _mm256_max_ps(sum, zero);
+            }
+
+            _mm256_storeu_ps(outputs + sample * padded + output, sum);
+        }
+    }
+}
+
+#endif
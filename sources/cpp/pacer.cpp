@@ -0,0 +1,180 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include "pacer.h"
+#include "process.h"
+
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+const char* const PACING_MODE_NAMES[]{ "coarse", "hybrid", "vsync" };
+
+FramePacer::FramePacer(unsigned int frameRate, Mode mode, double spinMicroseconds)
+    : mode(mode), spin(chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double, micro>(spinMicroseconds)))
+{
+    SetFrameRate(frameRate);
+    Restart();
+    ResetStatistics();
+}
+
+void FramePacer::SetFrameRate(unsigned int frameRate)
+{
+    period = frameRate > 0 ? chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(1.0 / frameRate)) : chrono::steady_clock::duration::zero();
+}
+
+FramePacer::Mode FramePacer::GetMode() const
+{
+    return mode;
+}
+
+void FramePacer::Wait()
+{
+    if (period > chrono::steady_clock::duration::zero())
+    {
+        if (mode == Coarse)
+        {
+            // Rest of the period since the previous frame, the error of the sleep is carried to the next frames
+            const chrono::steady_clock::duration elapsed = chrono::steady_clock::now() - last;
+
+            if (elapsed < period)
+            {
+                sf::sleep(sf::microseconds(chrono::duration_cast<chrono::microseconds>(period - elapsed).count()));
+            }
+        }
+        else if (mode == Hybrid)
+        {
+            // Boundaries on a fixed grid, so an early or late frame doesn't shift the next ones
+            next += period;
+            const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+
+            if (now >= next)
+            {
+                // More than one frame late, the missed frames are not caught up
+                if (now - next > period)
+                {
+                    next = now;
+                }
+            }
+            else
+            {
+                if (next - now > spin)
+                {
+                    sf::sleep(sf::microseconds(chrono::duration_cast<chrono::microseconds>(next - now - spin).count()));
+                }
+
+                while (chrono::steady_clock::now() < next)
+                {
+                    this_thread::yield();
+                }
+            }
+        }
+    }
+
+    Record(chrono::steady_clock::now());
+}
+
+void FramePacer::Restart()
+{
+    next = chrono::steady_clock::now();
+    last = next;
+    hasLast = false;
+}
+
+void FramePacer::ResetStatistics()
+{
+    errors.Reset();
+    intervalSum = 0.0;
+    intervalSquareSum = 0.0;
+    lateFrames = 0;
+}
+
+void FramePacer::Report(ostream& stream) const
+{
+    const unsigned long long count = errors.GetCount();
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    const double mean = intervalSum / count;
+    const double deviation = sqrt(max(0.0, intervalSquareSum / count - mean * mean));
+    char line[200];
+
+    snprintf(line, sizeof(line), "%-12s %-6s interval %9.1f us  stddev %7.1f us  error mean %7.1f  p99 %7.1f  max %9.1f us  late %llu",
+        "Pacing", PACING_MODE_NAMES[mode], mean, deviation, errors.GetMean(), errors.GetPercentile(99.0), errors.GetMax(), lateFrames);
+    stream << line << "\n";
+}
+
+void FramePacer::Record(chrono::steady_clock::time_point now)
+{
+    if (hasLast && period > chrono::steady_clock::duration::zero())
+    {
+        const double interval = chrono::duration<double, micro>(now - last).count();
+        const double target = chrono::duration<double, micro>(period).count();
+
+        errors.Record(abs(interval - target));
+        intervalSum += interval;
+        intervalSquareSum += interval * interval;
+
+        if (interval > target * 1.5)
+        {
+            lateFrames++;
+        }
+    }
+
+    last = now;
+    hasLast = true;
+}
+
+// --pacing [seconds] [frame rate] [spin microseconds]
+// Each mode waits for empty frames, the processor time includes the spinning
+int RunPacing(int argc, char* argv[])
+{
+    const double seconds = argc > 2 ? stod(argv[2]) : 3.0;
+    const unsigned int frameRate = argc > 3 ? static_cast<unsigned int>(stoul(argv[3])) : 60;
+    const double spinMicroseconds = argc > 4 ? stod(argv[4]) : 2000.0;
+
+    for (const FramePacer::Mode mode : { FramePacer::Coarse, FramePacer::Hybrid })
+    {
+        FramePacer pacer(frameRate, mode, spinMicroseconds);
+        const double cpuStart = GetCpuTime();
+        const unsigned long long frames = static_cast<unsigned long long>(seconds * frameRate);
+
+        for (unsigned long long frame = 0; frame <= frames; frame++)
+        {
+            pacer.Wait();
+        }
+
+        pacer.Report(cout);
+        cout << "             cpu " << (GetCpuTime() - cpuStart) / seconds * 100.0 << " % of one core\n";
+    }
+
+    return 0;
+}
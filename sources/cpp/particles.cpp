@@ -0,0 +1,178 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "particles.h"
+
+#include "settings.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+// The arrays are rounded up to a multiple of LANES
+ParticleSystem::ParticleSystem(size_t capacity)
+    : capacity(capacity), count(0), vertices(Quads), random(0x9E3779B9u)
+{
+    const size_t padded = (capacity + LANES - 1) / LANES * LANES;
+
+    positionX.resize(padded);
+    positionY.resize(padded);
+    velocityX.resize(padded);
+    velocityY.resize(padded);
+    life.resize(padded);
+    inverseLifetime.resize(padded);
+    colors.resize(padded);
+}
+
+void ParticleSystem::Emit(Vector2f position, Color color, unsigned int emitted, float angle, float spread)
+{
+    const size_t end = min(capacity, count + emitted);
+
+    for (size_t index = count; index < end; index++)
+    {
+        const float direction = angle + (NextRandom() - 0.5f) * spread;
+        const float speed = PARTICLE_SPEED * (0.25f + 0.75f * NextRandom());
+        const float lifetime = PARTICLE_LIFETIME * (0.5f + 0.5f * NextRandom());
+
+        positionX[index] = position.x;
+        positionY[index] = position.y;
+        velocityX[index] = cos(direction) * speed;
+        velocityY[index] = sin(direction) * speed;
+        life[index] = lifetime;
+        inverseLifetime[index] = 1.f / lifetime;
+        colors[index] = color;
+    }
+    count = end;
+}
+
+void ParticleSystem::Update(float seconds)
+{
+    // Same slowdown whatever the frame time
+    const float drag = pow(PARTICLE_DRAG, seconds);
+    size_t index = 0;
+
+#if defined(SIMD_X86)
+    if (HasAvx2())
+    {
+        index = UpdateAvx2(seconds, drag);
+    }
+#endif
+
+    // Remaining particles, or all of them without AVX2 (simple enough for the compiler to vectorize)
+    for (; index < count; index++)
+    {
+        positionX[index] += velocityX[index] * seconds;
+        positionY[index] += velocityY[index] * seconds;
+        velocityX[index] *= drag;
+        velocityY[index] *= drag;
+        life[index] -= seconds;
+    }
+
+    // Dead particles are replaced by the last one, so the live particles stay contiguous
+    for (index = 0; index < count;)
+    {
+        if (life[index] > 0.f)
+        {
+            index++;
+            continue;
+        }
+
+        count--;
+        positionX[index] = positionX[count];
+        positionY[index] = positionY[count];
+        velocityX[index] = velocityX[count];
+        velocityY[index] = velocityY[count];
+        life[index] = life[count];
+        inverseLifetime[index] = inverseLifetime[count];
+        colors[index] = colors[count];
+    }
+}
+
+void ParticleSystem::BuildVertices()
+{
+    // Doesn't reallocate once the pool was full
+    vertices.resize(count * 4);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    const float half = PARTICLE_SIZE / 2.f;
+    // The fields are written in place, the constructor of Vertex is not inlined
+    Vertex* quad = &vertices[0];
+
+    for (size_t index = 0; index < count; index++, quad += 4)
+    {
+        const float x = positionX[index];
+        const float y = positionY[index];
+        Color color = colors[index];
+        color.a = static_cast<Uint8>(255.f * min(1.f, life[index] * inverseLifetime[index]));
+
+        quad[0].position.x = x - half;
+        quad[0].position.y = y - half;
+        quad[1].position.x = x + half;
+        quad[1].position.y = y - half;
+        quad[2].position.x = x + half;
+        quad[2].position.y = y + half;
+        quad[3].position.x = x - half;
+        quad[3].position.y = y + half;
+        quad[0].color = color;
+        quad[1].color = color;
+        quad[2].color = color;
+        quad[3].color = color;
+    }
+}
+
+void ParticleSystem::Draw(RenderTarget& target) const
+{
+    if (count > 0)
+    {
+        target.draw(vertices);
+    }
+}
+
+void ParticleSystem::Clear()
+{
+    count = 0;
+}
+
+size_t ParticleSystem::GetCount() const
+{
+    return count;
+}
+
+size_t ParticleSystem::GetCapacity() const
+{
+    return capacity;
+}
+
+// xorshift32, from 0 to 1
+float ParticleSystem::NextRandom()
+{
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return static_cast<float>(random >> 8) / 16777216.f;
+}
@@ -0,0 +1,57 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include "particles.h"
+#include "simd.h"
+
+#if defined(SIMD_X86)
+
+#include <immintrin.h>
+
+// Moves the particles 8 at a time, returns the number of particles updated (a multiple of LANES),
+// this file is the only one built with AVX2
+SIMD_TARGET_AVX2 size_t ParticleSystem::UpdateAvx2(float seconds, float drag)
+{
+    size_t index = 0;
+
+    const __m256 step = _mm256_set1_ps(seconds);
+    const __m256 dragFactor = _mm256_set1_ps(drag);
+
+    for (; index + LANES <= count; index += LANES)
+    {
+        const __m256 vx = _mm256_loadu_ps(&velocityX[index]);
+        const __m256 vy = _mm256_loadu_ps(&velocityY[index]);
+
+        _mm256_storeu_ps(&positionX[index], _mm256_add_ps(_mm256_loadu_ps(&positionX[index]), _mm256_mul_ps(vx, step)));
+        _mm256_storeu_ps(&positionY[index], _mm256_add_ps(_mm256_loadu_ps(&positionY[index]), _mm256_mul_ps(vy, step)));
+        _mm256_storeu_ps(&velocityX[index], _mm256_mul_ps(vx, dragFactor));
+        _mm256_storeu_ps(&velocityY[index], _mm256_mul_ps(vy, dragFactor));
+        _mm256_storeu_ps(&life[index], _mm256_sub_ps(_mm256_loadu_ps(&life[index]), step));
+    }
+
+    return index;
+}
+
+#endif
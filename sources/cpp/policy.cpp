@@ -0,0 +1,123 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "policy.h"
+
+#include "vecenv.h"
+
+#include <iostream>
+
+// Constructor
+Policy::Policy()
+{
+}
+
+bool Policy::LoadFromFile(const string& fileName)
+{
+    if (!network.LoadFromFile(fileName))
+    {
+        return false;
+    }
+
+    if (network.GetInputSize() != VecEnv::OBSERVATION_SIZE || network.GetOutputSize() != 3)
+    {
+        cerr << "Wrong network size for a policy: " << fileName << "\n";
+        network = Mlp();
+        return false;
+    }
+
+    return true;
+}
+
+bool Policy::IsLoaded() const
+{
+    return network.GetInputSize() > 0;
+}
+
+void Policy::Act(const float* observations, unsigned char* actions, size_t count)
+{
+    if (scores.size() < count * 3)
+    {
+        scores.resize(count * 3);
+    }
+
+    network.Evaluate(observations, scores.data(), count);
+
+    // Best score
+    for (size_t index = 0; index < count; index++)
+    {
+        const float* score = &scores[index * 3];
+        unsigned char action = VecEnv::ActionNone;
+
+        if (score[VecEnv::ActionUp] > score[action])
+        {
+            action = VecEnv::ActionUp;
+        }
+        if (score[VecEnv::ActionDown] > score[action])
+        {
+            action = VecEnv::ActionDown;
+        }
+
+        actions[index] = action;
+    }
+}
+
+// Decide the action of a single racket
+void Policy::Control(Input::Button& button, const Simulation::State& state, Player side)
+{
+    float observation[VecEnv::OBSERVATION_SIZE];
+    unsigned char action;
+
+    Observe(state, side, observation);
+    Act(observation, &action, 1);
+    Press(button, side, action);
+}
+
+void Policy::Observe(const Simulation::State& state, Player side, float* observation)
+{
+    VecEnv::Observe(state, observation);
+
+    if (side == PlayerLeft)
+    {
+        // Mirror the field so that the racket of the policy is always on the right
+        observation[0] = WINDOW_WIDTH - BALL_RADIUS * 2 - state.ballPosition.x;
+        observation[2] = -state.direction.x;
+        observation[5] = state.racketRY;
+        observation[6] = state.racketLY;
+    }
+}
+
+void Policy::Press(Input::Button& button, Player side, unsigned char action)
+{
+    if (side == PlayerLeft)
+    {
+        button.Z = action == VecEnv::ActionUp;
+        button.S = action == VecEnv::ActionDown;
+    }
+    else
+    {
+        button.up = action == VecEnv::ActionUp;
+        button.down = action == VecEnv::ActionDown;
+    }
+}
@@ -0,0 +1,201 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "process.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <dirent.h>
+#include <fstream>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#if defined(COUNT_ALLOCATIONS)
+
+// Allocation counters, relaxed because they are only statistics
+static atomic<unsigned long long> allocationCount{ 0 };
+static atomic<unsigned long long> deallocationCount{ 0 };
+static atomic<unsigned long long> allocatedBytes{ 0 };
+static atomic<unsigned long long> deallocatedBytes{ 0 };
+
+// The size is stored before the block, this keeps the alignment of malloc
+const size_t ALLOCATION_HEADER{ alignof(max_align_t) };
+
+static void* Allocate(size_t size)
+{
+    void* block = malloc(size + ALLOCATION_HEADER);
+
+    if (!block)
+    {
+        throw bad_alloc();
+    }
+
+    *static_cast<size_t*>(block) = size;
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+
+    return static_cast<char*>(block) + ALLOCATION_HEADER;
+}
+
+static void Deallocate(void* pointer)
+{
+    if (!pointer)
+    {
+        return;
+    }
+
+    void* block = static_cast<char*>(pointer) - ALLOCATION_HEADER;
+    deallocationCount.fetch_add(1, memory_order_relaxed);
+    deallocatedBytes.fetch_add(*static_cast<size_t*>(block), memory_order_relaxed);
+
+    free(block);
+}
+
+void* operator new(size_t size)
+{
+    return Allocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return Allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    Deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    Deallocate(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    Deallocate(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    Deallocate(pointer);
+}
+
+#endif
+
+ProcessStats GetProcessStats()
+{
+    ProcessStats stats{};
+
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS memory;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory)))
+    {
+        stats.resident = memory.WorkingSetSize;
+    }
+
+    DWORD handles = 0;
+    if (GetProcessHandleCount(GetCurrentProcess(), &handles))
+    {
+        stats.handles = handles;
+    }
+#elif defined(__linux__)
+    // Second value: resident pages
+    ifstream statm("/proc/self/statm");
+    size_t pages = 0;
+    size_t residentPages = 0;
+    if (statm >> pages >> residentPages)
+    {
+        stats.resident = residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    if (DIR* directory = opendir("/proc/self/fd"))
+    {
+        while (dirent* entry = readdir(directory))
+        {
+            if (entry->d_name[0] != '.')
+            {
+                stats.handles++;
+            }
+        }
+        closedir(directory);
+    }
+#endif
+
+#if defined(COUNT_ALLOCATIONS)
+    // Read last so the allocations made above are already freed
+    stats.allocations = allocationCount.load(memory_order_relaxed);
+    stats.liveAllocations = stats.allocations - deallocationCount.load(memory_order_relaxed);
+    stats.liveBytes = allocatedBytes.load(memory_order_relaxed) - deallocatedBytes.load(memory_order_relaxed);
+#endif
+
+    return stats;
+}
+
+double GetCpuTime()
+{
+#if defined(_WIN32)
+    FILETIME creation;
+    FILETIME exit;
+    FILETIME kernel;
+    FILETIME user;
+    if (GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+    {
+        // Units of 100 ns
+        const unsigned long long kernelTime = (static_cast<unsigned long long>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+        const unsigned long long userTime = (static_cast<unsigned long long>(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+        return static_cast<double>(kernelTime + userTime) / 1e7;
+    }
+#elif defined(__linux__)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+#endif
+    return 0.0;
+}
+
+bool GetPackageEnergy(double& joules)
+{
+#if defined(__linux__)
+    // Microjoules, wraps around at max_energy_range_uj
+    ifstream energy("/sys/class/powercap/intel-rapl:0/energy_uj");
+    unsigned long long microjoules = 0;
+    if (energy >> microjoules)
+    {
+        joules = static_cast<double>(microjoules) / 1e6;
+        return true;
+    }
+#endif
+    return false;
+}
@@ -0,0 +1,240 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "profiler.h"
+
+#include "settings.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// Overlay properties
+const float OVERLAY_WIDTH{ 260.f };
+const float OVERLAY_GRAPH_HEIGHT{ 60.f };
+// Frame time at the top of the graph (in microseconds)
+const float OVERLAY_GRAPH_MAX{ 33333.f };
+const unsigned int OVERLAY_FONT_SIZE{ 12 };
+// The text is only rebuilt every few frames
+const unsigned int OVERLAY_TEXT_INTERVAL{ 15 };
+
+// Constructor
+Profiler::Scope::Scope(Profiler& profiler, Phase phase)
+    : profiler(profiler), phase(phase), parent(profiler.active), start(chrono::steady_clock::now()), children(0.f)
+{
+    profiler.active = this;
+}
+
+Profiler::Scope::~Scope()
+{
+    const chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    const float elapsed = chrono::duration<float, micro>(end - start).count();
+
+    Trace::Complete(GetPhaseName(phase), start, end);
+
+    profiler.current.phases[phase] += elapsed - children;
+    profiler.active = parent;
+
+    if (parent)
+    {
+        parent->children += elapsed;
+    }
+}
+
+// Constructor
+Profiler::Profiler(const Font& font, size_t history)
+    : frames(max<size_t>(history, 1)), next(0), count(0), current(), active(nullptr),
+    frameStart(chrono::steady_clock::now()), visible(false), graph(Lines), text("", font, OVERLAY_FONT_SIZE)
+{
+    background.setFillColor(Color(0, 0, 0, 180));
+    text.setFillColor(Color::White);
+}
+
+// Close the current frame and start the next one, to call once at the top of the game loop
+void Profiler::NextFrame()
+{
+    const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+
+    current.total = chrono::duration<float, micro>(now - frameStart).count();
+    Trace::Complete("Frame", frameStart, now);
+    frames[next] = current;
+    next = (next + 1) % frames.size();
+    count = min(count + 1, frames.size());
+
+    const unsigned long long index = current.index + 1;
+    current = Frame();
+    current.index = index;
+    frameStart = now;
+}
+
+void Profiler::Toggle()
+{
+    visible = !visible;
+}
+
+bool Profiler::IsVisible() const
+{
+    return visible;
+}
+
+// Frame time graph and average / maximum time of each phase
+void Profiler::DrawOverlay(RenderTarget& target)
+{
+    if (!visible || count == 0)
+    {
+        return;
+    }
+
+    const size_t lines = PhaseCount + 2;
+    const float textHeight = static_cast<float>(lines * (OVERLAY_FONT_SIZE + 3));
+
+    background.setSize(Vector2f(OVERLAY_WIDTH, OVERLAY_GRAPH_HEIGHT + textHeight + 12.f));
+    background.setPosition(8.f, 8.f);
+
+    // One vertical line per frame, the most recent on the right
+    const float step = OVERLAY_WIDTH / static_cast<float>(frames.size());
+    const float bottom = 8.f + OVERLAY_GRAPH_HEIGHT;
+
+    graph.resize(count * 2 + 2);
+
+    // Budget of a frame at the frame rate limit, none without limit
+    const float frameBudget = FRAME_LIMIT > 0 ? 1e6f / static_cast<float>(FRAME_LIMIT) : 0.f;
+
+    for (size_t age = 0; age < count; age++)
+    {
+        const Frame& frame = frames[(next + frames.size() - 1 - age) % frames.size()];
+        const float x = 8.f + OVERLAY_WIDTH - step * static_cast<float>(age);
+        const float height = min(frame.total / OVERLAY_GRAPH_MAX, 1.f) * OVERLAY_GRAPH_HEIGHT;
+        const Color color = frameBudget > 0.f && frame.total > frameBudget * 1.1f ? Color::Red : Color::Green;
+
+        graph[age * 2] = Vertex(Vector2f(x, bottom), color);
+        graph[age * 2 + 1] = Vertex(Vector2f(x, bottom - height), color);
+    }
+
+    // Line of the budget, at the top of the graph if the budget is higher
+    const float budget = bottom - min(frameBudget / OVERLAY_GRAPH_MAX, 1.f) * OVERLAY_GRAPH_HEIGHT;
+    const Color budgetColor = frameBudget > 0.f ? Color::Yellow : Color::Transparent;
+    graph[count * 2] = Vertex(Vector2f(8.f, budget), budgetColor);
+    graph[count * 2 + 1] = Vertex(Vector2f(8.f + OVERLAY_WIDTH, budget), budgetColor);
+
+    if (current.index % OVERLAY_TEXT_INTERVAL == 0 || text.getString().isEmpty())
+    {
+        float sums[PhaseCount + 1] = {};
+        float maximums[PhaseCount + 1] = {};
+
+        for (size_t index = 0; index < count; index++)
+        {
+            const Frame& frame = frames[index];
+
+            for (int phase = 0; phase < PhaseCount; phase++)
+            {
+                sums[phase] += frame.phases[phase];
+                maximums[phase] = max(maximums[phase], frame.phases[phase]);
+            }
+
+            sums[PhaseCount] += frame.total;
+            maximums[PhaseCount] = max(maximums[PhaseCount], frame.total);
+        }
+
+        ostringstream stream;
+        stream << fixed << setprecision(2) << setw(10) << left << "ms" << setw(8) << right << "avg" << setw(8) << "max" << "\n";
+
+        for (int phase = 0; phase <= PhaseCount; phase++)
+        {
+            const char* name = phase == PhaseCount ? "Frame" : GetPhaseName(static_cast<Phase>(phase));
+            stream << setw(10) << left << name << setw(8) << right << sums[phase] / count / 1000.f << setw(8) << maximums[phase] / 1000.f << "\n";
+        }
+
+        text.setString(stream.str());
+    }
+
+    text.setPosition(14.f, bottom + 6.f);
+
+    target.draw(background);
+    target.draw(graph);
+    target.draw(text);
+}
+
+// Write the frames in the history, the oldest first
+bool Profiler::SaveToFile(const string& fileName) const
+{
+    ofstream file(fileName);
+
+    if (!file)
+    {
+        cerr << "Error writing profile file: " << fileName << "\n";
+        return false;
+    }
+
+    file << "frame,total_us";
+    for (int phase = 0; phase < PhaseCount; phase++)
+    {
+        file << "," << GetPhaseName(static_cast<Phase>(phase)) << "_us";
+    }
+    file << "\n";
+
+    for (size_t age = count; age > 0; age--)
+    {
+        const Frame& frame = frames[(next + frames.size() - age) % frames.size()];
+
+        file << frame.index << "," << frame.total;
+        for (int phase = 0; phase < PhaseCount; phase++)
+        {
+            file << "," << frame.phases[phase];
+        }
+        file << "\n";
+    }
+
+    return true;
+}
+
+const char* Profiler::GetPhaseName(Phase phase)
+{
+    switch (phase)
+    {
+    case Events:
+        return "Events";
+    case Buttons:
+        return "Buttons";
+    case Physics:
+        return "Physics";
+    case Hud:
+        return "Hud";
+    case Particles:
+        return "Particles";
+    case Draw:
+        return "Draw";
+    case Overlay:
+        return "Overlay";
+    case Display:
+        return "Display";
+    case Pacing:
+        return "Pacing";
+    default:
+        return "";
+    }
+}
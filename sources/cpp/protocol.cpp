@@ -0,0 +1,179 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "protocol.h"
+
+PacketType GetPacketType(const unsigned char* packet, size_t size)
+{
+    return static_cast<PacketType>(size > 0 ? packet[0] & ((1 << PACKET_TYPE_BITS) - 1) : 0);
+}
+
+// Writer with the type already written
+static BitWriter StartPacket(unsigned char* packet, PacketType type)
+{
+    BitWriter writer(packet);
+    writer.Write(type, PACKET_TYPE_BITS);
+    return writer;
+}
+
+size_t WriteJoin(unsigned char* packet)
+{
+    return StartPacket(packet, PacketJoin).Finish();
+}
+
+size_t WriteInput(unsigned char* packet, uint32_t tick, const Input::Button& button)
+{
+    BitWriter writer = StartPacket(packet, PacketInput);
+    writer.Write(tick, TICK_BITS);
+    EncodeButtons(writer, button);
+    return writer.Finish();
+}
+
+size_t ReadInput(const unsigned char* packet, size_t size, uint32_t& tick, Input::Button& button)
+{
+    BitReader reader(packet, size);
+
+    if (reader.Read(PACKET_TYPE_BITS) != PacketInput)
+    {
+        return 0;
+    }
+
+    tick = reader.Read(TICK_BITS);
+    button = DecodeButtons(reader);
+    return reader.IsValid() ? size : 0;
+}
+
+size_t WriteLeave(unsigned char* packet)
+{
+    return StartPacket(packet, PacketLeave).Finish();
+}
+
+size_t WriteWelcome(unsigned char* packet, uint32_t match, Player side)
+{
+    BitWriter writer = StartPacket(packet, PacketWelcome);
+    writer.Write(match, 32);
+    writer.Write(side == PlayerLeft ? 0 : 1, 1);
+    return writer.Finish();
+}
+
+size_t ReadWelcome(const unsigned char* packet, size_t size, uint32_t& match, Player& side)
+{
+    BitReader reader(packet, size);
+
+    if (reader.Read(PACKET_TYPE_BITS) != PacketWelcome)
+    {
+        return 0;
+    }
+
+    match = reader.Read(32);
+    side = reader.Read(1) == 0 ? PlayerLeft : PlayerRight;
+    return reader.IsValid() ? size : 0;
+}
+
+size_t WriteState(unsigned char* packet, uint32_t tick, const Simulation::State& state)
+{
+    BitWriter writer = StartPacket(packet, PacketState);
+    writer.Write(tick, TICK_BITS);
+    EncodeState(writer, state);
+    return writer.Finish();
+}
+
+size_t ReadState(const unsigned char* packet, size_t size, uint32_t& tick, Simulation::State& state)
+{
+    BitReader reader(packet, size);
+
+    if (reader.Read(PACKET_TYPE_BITS) != PacketState)
+    {
+        return 0;
+    }
+
+    tick = reader.Read(TICK_BITS);
+    Simulation::State decoded{};
+    DecodeState(reader, decoded);
+
+    if (!reader.IsValid())
+    {
+        return 0;
+    }
+
+    state = decoded;
+    return size;
+}
+
+size_t WriteKeyframe(unsigned char* frame, uint32_t tick, const Simulation::State& state)
+{
+    BitWriter writer(frame + 1);
+    writer.Write(FrameKeyframe, 1);
+    writer.Write(tick, TICK_BITS);
+    EncodeState(writer, state);
+
+    const size_t size = writer.Finish();
+    frame[0] = static_cast<unsigned char>(size);
+    return 1 + size;
+}
+
+size_t WriteDelta(unsigned char* frame, uint32_t tick, const Simulation::State& previous, const Simulation::State& state)
+{
+    BitWriter writer(frame + 1);
+    writer.Write(FrameDelta, 1);
+    writer.Write(tick, TICK_BITS);
+    EncodeStateDelta(writer, previous, state);
+
+    const size_t size = writer.Finish();
+    frame[0] = static_cast<unsigned char>(size);
+    return 1 + size;
+}
+
+size_t ReadFrame(const unsigned char* frame, size_t size, uint32_t& tick, Simulation::State& state, FrameType& type)
+{
+    if (size < 1 || frame[0] == 0 || frame[0] >= MAX_FRAME_SIZE || size < 1 + static_cast<size_t>(frame[0]))
+    {
+        return 0;
+    }
+
+    BitReader reader(frame + 1, frame[0]);
+    Simulation::State decoded = state;
+
+    const FrameType frameType = reader.Read(1) == FrameKeyframe ? FrameKeyframe : FrameDelta;
+    const uint32_t frameTick = reader.Read(TICK_BITS);
+
+    if (frameType == FrameKeyframe)
+    {
+        DecodeState(reader, decoded);
+    }
+    else
+    {
+        DecodeStateDelta(reader, decoded);
+    }
+
+    if (!reader.IsValid())
+    {
+        return 0;
+    }
+
+    type = frameType;
+    tick = frameTick;
+    state = decoded;
+    return 1 + frame[0];
+}
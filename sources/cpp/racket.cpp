@@ -48,3 +48,8 @@ Vector2f Racket::GetPosition()
 {
 	return rectangle.getPosition();
 }
+
+void Racket::SetPosition(Vector2f position)
+{
+	rectangle.setPosition(position);
+}
@@ -0,0 +1,655 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "relay.h"
+
+#include "settings.h"
+#include <iostream>
+
+#ifdef __linux__
+
+#include "ai.h"
+#include "protocol.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <thread>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Frames written by one system call
+const unsigned int WRITE_BATCH{ 64 };
+
+Relay::Relay() : listener(-1), stats{}
+{
+    epoll = epoll_create1(0);
+}
+
+Relay::~Relay()
+{
+    for (const pair<const int, unique_ptr<Spectator>>& spectator : spectators)
+    {
+        close(spectator.first);
+    }
+
+    if (listener >= 0)
+    {
+        close(listener);
+    }
+
+    close(epoll);
+}
+
+bool Relay::Listen(unsigned short port)
+{
+    listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+
+    // Several relays can share the port, one per core
+    const int enable = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    setsockopt(listener, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listener, SOMAXCONN) < 0)
+    {
+        cout << "RELAY PORT " << port << " NOT AVAILABLE\n";
+        return false;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event);
+
+    return true;
+}
+
+void Relay::Poll()
+{
+    epoll_event events[256];
+    int count;
+
+    do
+    {
+        count = epoll_wait(epoll, events, 256, 0);
+
+        for (int index = 0; index < count; index++)
+        {
+            if (events[index].data.ptr)
+            {
+                Read(*static_cast<Spectator*>(events[index].data.ptr));
+                continue;
+            }
+
+            int client;
+            while ((client = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK)) >= 0)
+            {
+                const int enable = 1;
+                setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+                setsockopt(client, SOL_SOCKET, SO_SNDBUF, &RELAY_SOCKET_BUFFER, sizeof(RELAY_SOCKET_BUFFER));
+
+                unique_ptr<Spectator> spectator = make_unique<Spectator>();
+                spectator->socket = client;
+                spectator->subscribed = false;
+                spectator->requestSize = 0;
+                spectator->offset = 0;
+                spectator->needsKeyframe = true;
+
+                epoll_event event{};
+                event.events = EPOLLIN;
+                event.data.ptr = spectator.get();
+                epoll_ctl(epoll, EPOLL_CTL_ADD, client, &event);
+
+                spectators[client] = move(spectator);
+            }
+        }
+    } while (count == 256);
+}
+
+// Subscription of a new spectator, or disconnection
+void Relay::Read(Spectator& spectator)
+{
+    unsigned char buffer[64];
+    const ssize_t size = recv(spectator.socket, buffer, sizeof(buffer), 0);
+
+    if (size == 0 || (size < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+    {
+        Remove(spectator);
+        return;
+    }
+
+    for (ssize_t index = 0; index < size && !spectator.subscribed; index++)
+    {
+        spectator.request[spectator.requestSize++] = buffer[index];
+
+        if (spectator.requestSize == 4)
+        {
+            spectator.match = static_cast<uint32_t>(spectator.request[0]) | static_cast<uint32_t>(spectator.request[1]) << 8 |
+                static_cast<uint32_t>(spectator.request[2]) << 16 | static_cast<uint32_t>(spectator.request[3]) << 24;
+            spectator.subscribed = true;
+
+            Channel& channel = channels[spectator.match];
+            spectator.index = channel.spectators.size();
+            channel.spectators.push_back(&spectator);
+        }
+    }
+}
+
+void Relay::Publish(uint32_t match, uint32_t tick, const Simulation::State& state)
+{
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    Channel& channel = channels[match];
+    shared_ptr<Snapshot> delta = make_shared<Snapshot>();
+    shared_ptr<Snapshot> keyframe;
+
+    delta->tick = tick;
+    delta->bytes.resize(MAX_FRAME_SIZE);
+
+    // Everybody gets a keyframe from time to time, the delta is then the keyframe
+    if (!channel.published || tick % RELAY_KEYFRAME_INTERVAL == 0)
+    {
+        delta->keyframe = true;
+        delta->bytes.resize(WriteKeyframe(delta->bytes.data(), tick, state));
+        keyframe = delta;
+    }
+    else
+    {
+        delta->keyframe = false;
+        delta->bytes.resize(WriteDelta(delta->bytes.data(), tick, channel.previous, state));
+    }
+
+    channel.published = true;
+    channel.previous = state;
+
+    // Backwards because a removed spectator is replaced by the last one
+    for (size_t index = channel.spectators.size(); index-- > 0;)
+    {
+        Spectator& spectator = *channel.spectators[index];
+
+        // Encoded once, only if a spectator needs it or is about to be dropped
+        if ((spectator.needsKeyframe || spectator.queue.size() >= RELAY_QUEUE_LIMIT) && !keyframe)
+        {
+            keyframe = make_shared<Snapshot>();
+            keyframe->tick = tick;
+            keyframe->keyframe = true;
+            keyframe->bytes.resize(MAX_FRAME_SIZE);
+            keyframe->bytes.resize(WriteKeyframe(keyframe->bytes.data(), tick, state));
+        }
+
+        Enqueue(spectator, delta, keyframe);
+
+        if (!Write(spectator))
+        {
+            Remove(spectator);
+        }
+    }
+
+    stats.ticks++;
+    stats.publishHistogram.Record(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+}
+
+void Relay::Enqueue(Spectator& spectator, const shared_ptr<const Snapshot>& delta, const shared_ptr<const Snapshot>& keyframe)
+{
+    // Too slow: the deltas it has not read are useless, it needs a keyframe
+    if (spectator.queue.size() >= RELAY_QUEUE_LIMIT)
+    {
+        // A frame partially sent must be finished
+        spectator.queue.erase(spectator.queue.begin() + (spectator.offset > 0 ? 1 : 0), spectator.queue.end());
+        spectator.needsKeyframe = true;
+        stats.drops++;
+    }
+
+    if (spectator.needsKeyframe)
+    {
+        spectator.queue.push_back(keyframe);
+        spectator.needsKeyframe = false;
+        stats.keyframes++;
+    }
+    else
+    {
+        spectator.queue.push_back(delta);
+    }
+}
+
+// Write the queued frames from the shared buffers, false if the spectator is disconnected
+bool Relay::Write(Spectator& spectator)
+{
+    while (!spectator.queue.empty())
+    {
+        iovec vectors[WRITE_BATCH];
+        size_t count = 0;
+        size_t total = 0;
+
+        for (const shared_ptr<const Snapshot>& snapshot : spectator.queue)
+        {
+            if (count == WRITE_BATCH)
+            {
+                break;
+            }
+
+            const size_t offset = count == 0 ? spectator.offset : 0;
+            vectors[count].iov_base = const_cast<unsigned char*>(snapshot->bytes.data() + offset);
+            vectors[count].iov_len = snapshot->bytes.size() - offset;
+            total += vectors[count].iov_len;
+            count++;
+        }
+
+        const ssize_t sent = writev(spectator.socket, vectors, static_cast<int>(count));
+
+        if (sent < 0)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        stats.bytes += sent;
+        size_t written = static_cast<size_t>(sent);
+
+        // Remove the frames that are completely sent
+        while (written > 0)
+        {
+            const size_t remaining = spectator.queue.front()->bytes.size() - spectator.offset;
+
+            if (written < remaining)
+            {
+                spectator.offset += written;
+                break;
+            }
+
+            written -= remaining;
+            stats.frames++;
+            spectator.queue.pop_front();
+            spectator.offset = 0;
+        }
+
+        // The socket buffer is full
+        if (static_cast<size_t>(sent) < total)
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+void Relay::Remove(Spectator& spectator)
+{
+    if (spectator.subscribed)
+    {
+        vector<Spectator*>& list = channels[spectator.match].spectators;
+        list[spectator.index] = list.back();
+        list[spectator.index]->index = spectator.index;
+        list.pop_back();
+    }
+
+    epoll_ctl(epoll, EPOLL_CTL_DEL, spectator.socket, nullptr);
+    close(spectator.socket);
+    spectators.erase(spectator.socket);
+}
+
+Relay::Stats Relay::CollectStats()
+{
+    Stats collected = stats;
+    collected.spectators = static_cast<unsigned int>(spectators.size());
+    stats = Stats{};
+
+    return collected;
+}
+
+// AI vs AI match ticked at the server rate and published to the relay
+static void PlayMatch(Relay& relay, const atomic<bool>& running, const function<void()>& everyTick)
+{
+    Simulation simulation;
+    AI cpuL(PlayerLeft, CPU_REACTION_DELAY, CPU_AIM_ERROR, 1);
+    AI cpuR(PlayerRight, CPU_REACTION_DELAY, CPU_AIM_ERROR, 2);
+    Collision collision = None;
+    uint32_t tick = 0;
+
+    const chrono::steady_clock::duration period = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(1. / SERVER_TICK_RATE));
+    chrono::steady_clock::time_point next = chrono::steady_clock::now();
+
+    while (running)
+    {
+        relay.Poll();
+
+        const Simulation::State& state = simulation.GetState();
+        Input::Button button{};
+        cpuL.Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
+        cpuL.Control(button, state.racketLY);
+        cpuR.Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
+        cpuR.Control(button, state.racketRY);
+
+        collision = simulation.Step(button);
+        if (simulation.GetState().win)
+        {
+            simulation.Reset();
+        }
+
+        relay.Publish(0, ++tick, simulation.GetState());
+        everyTick();
+
+        next += period;
+        this_thread::sleep_until(next);
+    }
+}
+
+int RunRelay(int argc, char* argv[])
+{
+    const unsigned short port = argc > 2 ? static_cast<unsigned short>(stoul(argv[2])) : RELAY_PORT;
+    Relay relay;
+
+    if (!relay.Listen(port))
+    {
+        return 1;
+    }
+
+    cout << "Relay listening on TCP port " << port << ", match 0\n";
+
+    const atomic<bool> running{ true };
+    chrono::steady_clock::time_point lastReport = chrono::steady_clock::now();
+
+    PlayMatch(relay, running, [&]()
+    {
+        if (chrono::steady_clock::now() - lastReport < chrono::seconds(5))
+        {
+            return;
+        }
+
+        lastReport = chrono::steady_clock::now();
+        const Relay::Stats stats = relay.CollectStats();
+        cout << stats.spectators << " spectators, " << stats.frames << " frames, " << stats.keyframes << " keyframes, " << stats.drops << " drops\n";
+        stats.publishHistogram.Report("Publish", cout);
+    });
+
+    return 0;
+}
+
+// Spectator of the benchmark, checks that no delta is missing
+struct BenchSpectator
+{
+    int socket;
+    unsigned char buffer[1024];
+    size_t size;
+    bool synced;
+    uint32_t tick;
+    Simulation::State state;
+};
+
+// Read all the complete frames, false if a delta does not follow the previous frame
+static bool ReadFrames(BenchSpectator& spectator)
+{
+    bool valid = true;
+
+    while (true)
+    {
+        const ssize_t received = recv(spectator.socket, spectator.buffer + spectator.size, sizeof(spectator.buffer) - spectator.size, 0);
+
+        if (received <= 0)
+        {
+            break;
+        }
+
+        spectator.size += received;
+        size_t position = 0;
+        size_t frameSize;
+        uint32_t tick;
+        FrameType type;
+
+        while ((frameSize = ReadFrame(spectator.buffer + position, spectator.size - position, tick, spectator.state, type)) > 0)
+        {
+            // Ticks are sent modulo 65536
+            if (type == FrameDelta && (!spectator.synced || tick != ((spectator.tick + 1) & 0xFFFF)))
+            {
+                valid = false;
+            }
+
+            spectator.synced = true;
+            spectator.tick = tick;
+            position += frameSize;
+        }
+
+        // Keep the incomplete frame
+        copy(spectator.buffer + position, spectator.buffer + spectator.size, spectator.buffer);
+        spectator.size -= position;
+    }
+
+    return valid;
+}
+
+static double GetThreadCpuSeconds()
+{
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) / 1e9;
+}
+
+int RunRelayBench(int argc, char* argv[])
+{
+    unsigned int count = argc > 2 ? static_cast<unsigned int>(stoul(argv[2])) : RELAY_BENCH_SPECTATORS;
+    const float seconds = argc > 3 ? stof(argv[3]) : 10.f;
+
+    // Both ends of each connection are in this process
+    rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    if (count > (limit.rlim_cur - 64) / 2)
+    {
+        count = static_cast<unsigned int>((limit.rlim_cur - 64) / 2);
+        cout << "Limited to " << count << " spectators by the number of open files\n";
+    }
+
+    const unsigned int stalledCount = static_cast<unsigned int>(count * RELAY_BENCH_STALLED);
+
+    Relay relay;
+    if (!relay.Listen(RELAY_PORT))
+    {
+        return 1;
+    }
+
+    // The relay runs on its own thread, to measure its CPU time
+    atomic<bool> running{ true };
+    atomic<bool> measuring{ false };
+    Relay::Stats stats{};
+    double cpuSeconds = 0.;
+    double wallSeconds = 0.;
+
+    thread relayThread([&]()
+    {
+        bool measured = false;
+        double cpuStart = 0.;
+        chrono::steady_clock::time_point wallStart;
+
+        PlayMatch(relay, running, [&]()
+        {
+            if (measuring && !measured)
+            {
+                relay.CollectStats();
+                cpuStart = GetThreadCpuSeconds();
+                wallStart = chrono::steady_clock::now();
+                measured = true;
+            }
+            else if (!measuring && measured)
+            {
+                stats = relay.CollectStats();
+                cpuSeconds = GetThreadCpuSeconds() - cpuStart;
+                wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+                measured = false;
+            }
+        });
+    });
+
+    vector<BenchSpectator> benchSpectators(count);
+    const int epoll = epoll_create1(0);
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(RELAY_PORT);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    const unsigned char request[4]{ 0, 0, 0, 0 };
+
+    for (unsigned int index = 0; index < count; index++)
+    {
+        BenchSpectator& spectator = benchSpectators[index];
+        spectator.socket = socket(AF_INET, SOCK_STREAM, 0);
+        spectator.size = 0;
+        spectator.synced = false;
+        spectator.tick = 0;
+
+        // The stalled spectators have a small buffer so their queue fills up
+        if (index < stalledCount)
+        {
+            const int bufferSize = 1024;
+            setsockopt(spectator.socket, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+        }
+
+        if (connect(spectator.socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+        {
+            cout << "Connection " << index << " failed\n";
+            running = false;
+            relayThread.join();
+            return 1;
+        }
+
+        send(spectator.socket, request, sizeof(request), 0);
+        fcntl(spectator.socket, F_SETFL, O_NONBLOCK);
+
+        if (index >= stalledCount)
+        {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.ptr = &spectator;
+            epoll_ctl(epoll, EPOLL_CTL_ADD, spectator.socket, &event);
+        }
+    }
+
+    unsigned long long errors = 0;
+
+    const auto readFor = [&](double duration, bool stalled)
+    {
+        const chrono::steady_clock::time_point end = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(duration));
+        epoll_event events[256];
+
+        while (chrono::steady_clock::now() < end)
+        {
+            const int ready = epoll_wait(epoll, events, 256, 10);
+
+            for (int index = 0; index < ready; index++)
+            {
+                errors += ReadFrames(*static_cast<BenchSpectator*>(events[index].data.ptr)) ? 0 : 1;
+            }
+
+            for (unsigned int index = 0; index < stalledCount && !stalled; index++)
+            {
+                errors += ReadFrames(benchSpectators[index]) ? 0 : 1;
+            }
+        }
+    };
+
+    // Let the relay accept everybody, then measure while some spectators stall, and let them catch up
+    readFor(1., false);
+    measuring = true;
+    readFor(seconds, true);
+    measuring = false;
+    readFor(1., false);
+
+    running = false;
+    relayThread.join();
+
+    for (BenchSpectator& spectator : benchSpectators)
+    {
+        close(spectator.socket);
+    }
+    close(epoll);
+
+    const double cpuShare = cpuSeconds / wallSeconds;
+
+    cout << "Spectators: " << stats.spectators << " (" << stalledCount << " stalled), " << stats.ticks << " ticks in " << wallSeconds << " s\n";
+    cout << "Frames: " << stats.frames / wallSeconds << " /s, " << stats.bytes / wallSeconds / 1e6 << " MB/s, "
+        << stats.keyframes << " keyframes, " << stats.drops << " queues dropped\n";
+    stats.publishHistogram.Report("Publish", cout);
+    cout << "Relay CPU: " << cpuShare * 100. << "% of a core, about " << static_cast<unsigned int>(stats.spectators / max(cpuShare, 1e-6))
+        << " spectators per core at " << SERVER_TICK_RATE << " Hz\n";
+    cout << "Missing deltas: " << errors << '\n';
+
+    return errors == 0 ? 0 : 1;
+}
+
+#else
+
+Relay::Relay() : listener(-1), epoll(-1), stats{}
+{
+}
+
+Relay::~Relay()
+{
+}
+
+bool Relay::Listen(unsigned short)
+{
+    cout << "The spectator relay needs Linux (epoll)\n";
+    return false;
+}
+
+void Relay::Poll()
+{
+}
+
+void Relay::Publish(uint32_t, uint32_t, const Simulation::State&)
+{
+}
+
+Relay::Stats Relay::CollectStats()
+{
+    return Stats{};
+}
+
+int RunRelay(int, char*[])
+{
+    cout << "The spectator relay needs Linux (epoll)\n";
+    return 1;
+}
+
+int RunRelayBench(int, char*[])
+{
+    cout << "The spectator relay needs Linux (epoll)\n";
+    return 1;
+}
+
+#endif
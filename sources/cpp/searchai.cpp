@@ -0,0 +1,202 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "searchai.h"
+
+#include <algorithm>
+#include <chrono>
+
+// Constructor
+SearchAI::SearchAI(Player side, ThreadPool& pool, float budgetMs, unsigned int seed)
+    : side(side), pool(pool), budgetMs(budgetMs), seed(seed), rollouts(SEARCH_ROLLOUTS),
+    fallback(side, CPU_REACTION_DELAY, CPU_AIM_ERROR, seed),
+    values(MoveCount * SEARCH_ROLLOUTS), finished(MoveCount * SEARCH_ROLLOUTS)
+{
+    stats = Stats{};
+}
+
+void SearchAI::Reset()
+{
+    fallback.Reset();
+}
+
+void SearchAI::Observe(Collision collision, const Simulation::State& state)
+{
+    fallback.Observe(collision, state.ballPosition, state.direction, state.ballSpeed);
+}
+
+void SearchAI::Control(Input::Button& button, const Simulation::State& state)
+{
+    const auto start = chrono::steady_clock::now();
+    const auto deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<float, milli>(budgetMs));
+    const size_t count = MoveCount * rollouts;
+
+    // Moves are interleaved so that each of them gets the same number of rollouts when the time is over
+    auto task = [&](size_t begin, size_t end)
+    {
+        for (size_t index = begin; index < end; index++)
+        {
+            finished[index] = 0;
+
+            if (chrono::steady_clock::now() >= deadline)
+            {
+                continue;
+            }
+
+            const Move move = static_cast<Move>(index % MoveCount);
+            values[index] = Rollout(state, move, seed + static_cast<unsigned int>(stats.decisions * count + index), finished[index]);
+        }
+    };
+
+    pool.ParallelFor(count, task);
+
+    // What the predictive AI would do, used for ties and when nothing was finished
+    Input::Button predicted{};
+    fallback.Control(predicted, side == PlayerLeft ? state.racketLY : state.racketRY);
+    const bool predictedUp = side == PlayerLeft ? predicted.Z : predicted.up;
+    const bool predictedDown = side == PlayerLeft ? predicted.S : predicted.down;
+    const Move predictedMove = predictedUp ? MoveUp : predictedDown ? MoveDown : Stay;
+
+    float sums[MoveCount] = {};
+    unsigned int counts[MoveCount] = {};
+    unsigned long long frames = 0;
+
+    for (size_t index = 0; index < count; index++)
+    {
+        if (finished[index])
+        {
+            sums[index % MoveCount] += values[index];
+            counts[index % MoveCount]++;
+            frames += finished[index];
+        }
+    }
+
+    Move best = predictedMove;
+
+    if (counts[Stay] > 0 && counts[MoveUp] > 0 && counts[MoveDown] > 0)
+    {
+        float bestValue = sums[predictedMove] / counts[predictedMove];
+
+        for (int move = Stay; move < MoveCount; move++)
+        {
+            const float value = sums[move] / counts[move];
+
+            if (value > bestValue)
+            {
+                bestValue = value;
+                best = static_cast<Move>(move);
+            }
+        }
+    }
+    else
+    {
+        stats.fallbacks++;
+    }
+
+    Press(button, best);
+
+    // Adapt the number of rollouts to the time budget for the next frames
+    const double milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    if (milliseconds > budgetMs)
+    {
+        stats.overBudget++;
+        rollouts = max(1u, rollouts / 2);
+    }
+    else if (milliseconds < budgetMs / 2 && rollouts < SEARCH_ROLLOUTS)
+    {
+        rollouts++;
+    }
+
+    stats.decisions++;
+    stats.rollouts += counts[Stay] + counts[MoveUp] + counts[MoveDown];
+    stats.frames += frames;
+    stats.seconds += milliseconds / 1000.0;
+}
+
+const SearchAI::Stats& SearchAI::GetStats() const
+{
+    return stats;
+}
+
+// Play the move for a few frames then let both players act like the predictive AI.
+// Returns 1 if this player scores, -1 if the opponent scores and 0 if nobody scores before the horizon.
+// frames is set to the number of frames stepped, a point ends the rollout early.
+float SearchAI::Rollout(const Simulation::State& state, Move move, unsigned int rolloutSeed, unsigned int& frames) const
+{
+    Simulation simulation;
+    simulation.SetState(state);
+
+    const Player opponentSide = side == PlayerLeft ? PlayerRight : PlayerLeft;
+    AI self(side, 0, CPU_AIM_ERROR / 2.f, rolloutSeed);
+    AI opponent(opponentSide, CPU_REACTION_DELAY, CPU_AIM_ERROR, ~rolloutSeed);
+    Collision collision = None;
+
+    for (unsigned int frame = 0; frame < SEARCH_HORIZON; frame++)
+    {
+        const Simulation::State& current = simulation.GetState();
+        Input::Button button{};
+
+        self.Observe(collision, current.ballPosition, current.direction, current.ballSpeed);
+        opponent.Observe(collision, current.ballPosition, current.direction, current.ballSpeed);
+        opponent.Control(button, opponentSide == PlayerLeft ? current.racketLY : current.racketRY);
+
+        if (frame < SEARCH_COMMIT_FRAMES)
+        {
+            Press(button, move);
+        }
+        else
+        {
+            self.Control(button, side == PlayerLeft ? current.racketLY : current.racketRY);
+        }
+
+        collision = simulation.Step(button);
+        frames = frame + 1;
+
+        if (collision == LeftWindow)
+        {
+            return side == PlayerRight ? 1.f : -1.f;
+        }
+        if (collision == RightWindow)
+        {
+            return side == PlayerLeft ? 1.f : -1.f;
+        }
+    }
+
+    return 0.f;
+}
+
+void SearchAI::Press(Input::Button& button, Move move) const
+{
+    if (side == PlayerLeft)
+    {
+        button.Z = move == MoveUp;
+        button.S = move == MoveDown;
+    }
+    else
+    {
+        button.up = move == MoveUp;
+        button.down = move == MoveDown;
+    }
+}
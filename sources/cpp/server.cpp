@@ -0,0 +1,593 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "server.h"
+
+#include "settings.h"
+#include <iostream>
+#include <string>
+
+#ifdef __linux__
+
+#include "protocol.h"
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// Datagrams received or sent by one system call
+const unsigned int PACKET_BATCH{ 64 };
+// Kernel buffer of each worker socket, enough for a few ticks of thousands of clients
+const int SOCKET_BUFFER_SIZE{ 8 << 20 };
+
+struct ServerMatch
+{
+    uint32_t id;
+    // Position in the match list of the worker, for the removal
+    size_t index;
+    Simulation simulation;
+    uint32_t tick;
+    sockaddr_in addresses[2];
+    bool connected[2];
+    Input::Button buttons[2];
+};
+
+struct ServerClient
+{
+    ServerMatch* match;
+    Player side;
+    chrono::steady_clock::time_point lastPacket;
+};
+
+struct GameServer::Worker
+{
+    unsigned int index;
+    int socket = -1;
+    int epoll = -1;
+    int timer = -1;
+    thread loop;
+
+    // Clients by address, and matches ticked by this worker
+    unordered_map<uint64_t, ServerClient> clients;
+    vector<unique_ptr<ServerMatch>> matches;
+    ServerMatch* waiting = nullptr;
+    uint32_t nextMatch = 0;
+
+    // Outgoing datagrams of the current batch
+    mmsghdr messages[PACKET_BATCH];
+    iovec vectors[PACKET_BATCH];
+    unsigned char packets[PACKET_BATCH][MAX_PACKET_SIZE];
+    size_t sizes[PACKET_BATCH];
+    sockaddr_in addresses[PACKET_BATCH];
+    unsigned int pending = 0;
+
+    unsigned long long packetsReceived = 0;
+    unsigned long long packetsSent = 0;
+
+    // Read by CollectStats
+    mutex statsMutex;
+    Stats stats{};
+
+    void Run(const atomic<bool>& running);
+    void Receive();
+    void Handle(const unsigned char* packet, size_t size, const sockaddr_in& address);
+    void Tick(unsigned long long expirations);
+    void RemoveMatch(ServerMatch* match);
+    void RemoveIdleClients();
+    unsigned char* Queue(const sockaddr_in& address);
+    void Commit(size_t size);
+    void Flush();
+};
+
+static uint64_t GetAddressKey(const sockaddr_in& address)
+{
+    return static_cast<uint64_t>(address.sin_addr.s_addr) << 16 | address.sin_port;
+}
+
+// Open a socket on the shared port, with its epoll and its tick timer
+static bool OpenWorker(int& udpSocket, int& epoll, int& timer, unsigned short port)
+{
+    udpSocket = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    if (udpSocket < 0)
+    {
+        return false;
+    }
+
+    const int enable = 1;
+    setsockopt(udpSocket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+    setsockopt(udpSocket, SOL_SOCKET, SO_RCVBUF, &SOCKET_BUFFER_SIZE, sizeof(SOCKET_BUFFER_SIZE));
+    setsockopt(udpSocket, SOL_SOCKET, SO_SNDBUF, &SOCKET_BUFFER_SIZE, sizeof(SOCKET_BUFFER_SIZE));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (bind(udpSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        return false;
+    }
+
+    timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    itimerspec period{};
+    period.it_interval.tv_nsec = 1000000000L / SERVER_TICK_RATE;
+    period.it_value = period.it_interval;
+    timerfd_settime(timer, 0, &period, nullptr);
+
+    epoll = epoll_create1(0);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = udpSocket;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, udpSocket, &event);
+    event.data.fd = timer;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, timer, &event);
+
+    return true;
+}
+
+void GameServer::Worker::Run(const atomic<bool>& running)
+{
+    epoll_event events[2];
+    chrono::steady_clock::time_point lastCheck = chrono::steady_clock::now();
+
+    while (running.load(memory_order_relaxed))
+    {
+        // The timeout lets the loop see that the server is stopped
+        const int count = epoll_wait(epoll, events, 2, 100);
+
+        for (int event = 0; event < count; event++)
+        {
+            if (events[event].data.fd == socket)
+            {
+                Receive();
+            }
+            else
+            {
+                unsigned long long expirations = 0;
+                if (read(timer, &expirations, sizeof(expirations)) == sizeof(expirations))
+                {
+                    Tick(expirations);
+                }
+            }
+        }
+
+        if (chrono::steady_clock::now() - lastCheck > chrono::seconds(1))
+        {
+            RemoveIdleClients();
+            lastCheck = chrono::steady_clock::now();
+        }
+    }
+}
+
+// Read all the waiting datagrams, by batches
+void GameServer::Worker::Receive()
+{
+    mmsghdr received[PACKET_BATCH];
+    iovec receivedVectors[PACKET_BATCH];
+    unsigned char receivedPackets[PACKET_BATCH][MAX_PACKET_SIZE];
+    sockaddr_in receivedAddresses[PACKET_BATCH];
+
+    for (unsigned int index = 0; index < PACKET_BATCH; index++)
+    {
+        receivedVectors[index] = { receivedPackets[index], MAX_PACKET_SIZE };
+        received[index].msg_hdr = {};
+        received[index].msg_hdr.msg_name = &receivedAddresses[index];
+        received[index].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        received[index].msg_hdr.msg_iov = &receivedVectors[index];
+        received[index].msg_hdr.msg_iovlen = 1;
+    }
+
+    while (true)
+    {
+        const int count = recvmmsg(socket, received, PACKET_BATCH, MSG_DONTWAIT, nullptr);
+
+        if (count <= 0)
+        {
+            break;
+        }
+
+        for (int index = 0; index < count; index++)
+        {
+            Handle(receivedPackets[index], received[index].msg_len, receivedAddresses[index]);
+            received[index].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        }
+
+        packetsReceived += count;
+    }
+
+    Flush();
+}
+
+void GameServer::Worker::Handle(const unsigned char* packet, size_t size, const sockaddr_in& address)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    const uint64_t key = GetAddressKey(address);
+    const unordered_map<uint64_t, ServerClient>::iterator client = clients.find(key);
+
+    if (client == clients.end())
+    {
+        if (GetPacketType(packet, size) != PacketJoin)
+        {
+            return;
+        }
+
+        // The first client of a match waits for the second one
+        Player side = PlayerRight;
+        if (!waiting)
+        {
+            unique_ptr<ServerMatch> match = make_unique<ServerMatch>();
+            match->id = (nextMatch++) * 256 + index;
+            match->index = matches.size();
+            match->tick = 0;
+            match->connected[PlayerRight] = false;
+            match->buttons[PlayerLeft] = {};
+            match->buttons[PlayerRight] = {};
+            waiting = match.get();
+            matches.push_back(move(match));
+            side = PlayerLeft;
+        }
+
+        ServerMatch* match = waiting;
+        match->addresses[side] = address;
+        match->connected[side] = true;
+        if (side == PlayerRight)
+        {
+            waiting = nullptr;
+        }
+
+        clients[key] = { match, side, chrono::steady_clock::now() };
+        Commit(WriteWelcome(Queue(address), match->id, side));
+        return;
+    }
+
+    ServerClient& known = client->second;
+    known.lastPacket = chrono::steady_clock::now();
+
+    Input::Button button;
+    uint32_t tick;
+
+    switch (GetPacketType(packet, size))
+    {
+    case PacketJoin:
+        // The welcome was lost
+        Commit(WriteWelcome(Queue(address), known.match->id, known.side));
+        break;
+    case PacketInput:
+        if (ReadInput(packet, size, tick, button))
+        {
+            known.match->buttons[known.side] = button;
+        }
+        break;
+    case PacketLeave:
+        RemoveMatch(known.match);
+        break;
+    default:
+        break;
+    }
+}
+
+// Step and broadcast all the full matches
+void GameServer::Worker::Tick(unsigned long long expirations)
+{
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    for (const unique_ptr<ServerMatch>& match : matches)
+    {
+        if (!match->connected[PlayerLeft] || !match->connected[PlayerRight])
+        {
+            continue;
+        }
+
+        // Each client only controls its racket
+        Input::Button button{};
+        button.Z = match->buttons[PlayerLeft].Z;
+        button.S = match->buttons[PlayerLeft].S;
+        button.up = match->buttons[PlayerRight].up;
+        button.down = match->buttons[PlayerRight].down;
+
+        match->simulation.Step(button);
+        match->tick++;
+
+        if (match->simulation.GetState().win)
+        {
+            match->simulation.Reset();
+        }
+
+        for (const sockaddr_in& address : match->addresses)
+        {
+            Commit(WriteState(Queue(address), match->tick, match->simulation.GetState()));
+        }
+    }
+
+    Flush();
+
+    const double microseconds = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+    lock_guard<mutex> lock(statsMutex);
+    stats.matches = static_cast<unsigned int>(matches.size() - (waiting ? 1 : 0));
+    stats.clients = static_cast<unsigned int>(clients.size());
+    stats.ticks++;
+    stats.lateTicks += expirations - 1;
+    stats.packetsReceived += packetsReceived;
+    stats.packetsSent += packetsSent;
+    stats.tickHistogram.Record(microseconds);
+    packetsReceived = 0;
+    packetsSent = 0;
+}
+
+void GameServer::Worker::RemoveMatch(ServerMatch* match)
+{
+    for (Player side : { PlayerLeft, PlayerRight })
+    {
+        if (match->connected[side])
+        {
+            clients.erase(GetAddressKey(match->addresses[side]));
+        }
+    }
+
+    if (waiting == match)
+    {
+        waiting = nullptr;
+    }
+
+    // Swap with the last match
+    const size_t position = match->index;
+    swap(matches[position], matches.back());
+    matches[position]->index = position;
+    matches.pop_back();
+}
+
+void GameServer::Worker::RemoveIdleClients()
+{
+    const chrono::steady_clock::time_point limit = chrono::steady_clock::now() - chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<float>(SERVER_CLIENT_TIMEOUT));
+    vector<ServerMatch*> idle;
+
+    for (const pair<const uint64_t, ServerClient>& client : clients)
+    {
+        if (client.second.lastPacket < limit)
+        {
+            idle.push_back(client.second.match);
+        }
+    }
+
+    // Both clients of a match can be idle
+    sort(idle.begin(), idle.end());
+    idle.erase(unique(idle.begin(), idle.end()), idle.end());
+
+    for (ServerMatch* match : idle)
+    {
+        RemoveMatch(match);
+    }
+}
+
+// Buffer of the next outgoing datagram, the batch is sent when it is full
+unsigned char* GameServer::Worker::Queue(const sockaddr_in& address)
+{
+    if (pending == PACKET_BATCH)
+    {
+        Flush();
+    }
+
+    addresses[pending] = address;
+    return packets[pending];
+}
+
+// Add the datagram written in the buffer given by Queue to the batch
+void GameServer::Worker::Commit(size_t size)
+{
+    sizes[pending++] = size;
+}
+
+void GameServer::Worker::Flush()
+{
+    for (unsigned int index = 0; index < pending; index++)
+    {
+        vectors[index] = { packets[index], sizes[index] };
+        messages[index].msg_hdr = {};
+        messages[index].msg_hdr.msg_name = &addresses[index];
+        messages[index].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        messages[index].msg_hdr.msg_iov = &vectors[index];
+        messages[index].msg_hdr.msg_iovlen = 1;
+    }
+
+    unsigned int sent = 0;
+
+    while (sent < pending)
+    {
+        const int count = sendmmsg(socket, messages + sent, pending - sent, 0);
+
+        // The datagrams are dropped if the kernel buffer is full, like on the network
+        if (count <= 0)
+        {
+            break;
+        }
+
+        sent += count;
+    }
+
+    packetsSent += sent;
+    pending = 0;
+}
+
+GameServer::GameServer() : running(false)
+{
+}
+
+GameServer::~GameServer()
+{
+    Stop();
+}
+
+bool GameServer::Start(unsigned short port, unsigned int workerCount)
+{
+    if (workerCount == 0)
+    {
+        workerCount = max(1u, thread::hardware_concurrency());
+    }
+
+    running = true;
+
+    for (unsigned int index = 0; index < workerCount; index++)
+    {
+        unique_ptr<Worker> worker = make_unique<Worker>();
+        worker->index = index;
+
+        if (!OpenWorker(worker->socket, worker->epoll, worker->timer, port))
+        {
+            cout << "SERVER PORT " << port << " NOT AVAILABLE\n";
+            Stop();
+            return false;
+        }
+
+        workers.push_back(move(worker));
+    }
+
+    // Started once all the sockets are bound
+    for (const unique_ptr<Worker>& worker : workers)
+    {
+        worker->loop = thread(&Worker::Run, worker.get(), cref(running));
+    }
+
+    return true;
+}
+
+void GameServer::Stop()
+{
+    running = false;
+
+    for (const unique_ptr<Worker>& worker : workers)
+    {
+        if (worker->loop.joinable())
+        {
+            worker->loop.join();
+        }
+
+        close(worker->socket);
+        close(worker->epoll);
+        close(worker->timer);
+    }
+
+    workers.clear();
+}
+
+GameServer::Stats GameServer::CollectStats()
+{
+    Stats total{};
+    total.workers = static_cast<unsigned int>(workers.size());
+
+    for (const unique_ptr<Worker>& worker : workers)
+    {
+        lock_guard<mutex> lock(worker->statsMutex);
+
+        total.matches += worker->stats.matches;
+        total.clients += worker->stats.clients;
+        total.ticks += worker->stats.ticks;
+        total.lateTicks += worker->stats.lateTicks;
+        total.packetsReceived += worker->stats.packetsReceived;
+        total.packetsSent += worker->stats.packetsSent;
+        total.tickHistogram.Merge(worker->stats.tickHistogram);
+
+        // The match and client counts are kept, they are not totals
+        const unsigned int matches = worker->stats.matches;
+        const unsigned int clients = worker->stats.clients;
+        worker->stats = Stats{};
+        worker->stats.matches = matches;
+        worker->stats.clients = clients;
+    }
+
+    return total;
+}
+
+int RunServer(int argc, char* argv[])
+{
+    const unsigned short port = argc > 2 ? static_cast<unsigned short>(stoul(argv[2])) : SERVER_PORT;
+    GameServer server;
+
+    if (!server.Start(port, argc > 3 ? static_cast<unsigned int>(stoul(argv[3])) : SERVER_WORKERS))
+    {
+        return 1;
+    }
+
+    cout << "Server listening on UDP port " << port << '\n';
+
+    while (true)
+    {
+        this_thread::sleep_for(chrono::seconds(5));
+
+        const GameServer::Stats stats = server.CollectStats();
+        cout << stats.matches << " matches, " << stats.clients << " clients, "
+            << stats.ticks / 5. / stats.workers << " ticks/s per worker, " << stats.lateTicks << " late ticks\n";
+        stats.tickHistogram.Report("Tick", cout);
+    }
+}
+
+#else
+
+struct GameServer::Worker
+{
+};
+
+GameServer::GameServer() : running(false)
+{
+}
+
+GameServer::~GameServer()
+{
+}
+
+bool GameServer::Start(unsigned short, unsigned int)
+{
+    cout << "The game server needs Linux (epoll)\n";
+    return false;
+}
+
+void GameServer::Stop()
+{
+}
+
+GameServer::Stats GameServer::CollectStats()
+{
+    return Stats{};
+}
+
+int RunServer(int, char*[])
+{
+    cout << "The game server needs Linux (epoll)\n";
+    return 1;
+}
+
+#endif
@@ -0,0 +1,262 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "simulation.h"
+
+// Constructor
+Simulation::Simulation()
+{
+    Reset();
+}
+
+// Start a new match
+void Simulation::Reset()
+{
+    state.ballPosition = Vector2f(static_cast<float>(DEFAULT_BALL_POS_X), static_cast<float>(DEFAULT_BALL_POS_Y));
+    state.ballSpeed = DEFAULT_BALL_SPEED;
+    state.racketLY = static_cast<float>(DEFAULT_RACKET_L_POS_Y);
+    state.racketRY = static_cast<float>(DEFAULT_RACKET_R_POS_Y);
+    state.scoreL = 0;
+    state.scoreR = 0;
+    state.collisionCount = 0;
+    state.win = false;
+
+    Serve();
+}
+
+// Advance the match by one frame and return the collision that was handled
+Collision Simulation::Step(const Input::Button& button)
+{
+    // Move the rackets, limited by the window
+    if (button.Z && state.racketLY > RACKET_L_MIN_POS_Y)
+    {
+        state.racketLY -= RACKET_L_SPEED;
+    }
+    if (button.S && state.racketLY < RACKET_L_MAX_POS_Y)
+    {
+        state.racketLY += RACKET_L_SPEED;
+    }
+    if (button.up && state.racketRY > RACKET_R_MIN_POS_Y)
+    {
+        state.racketRY -= RACKET_R_SPEED;
+    }
+    if (button.down && state.racketRY < RACKET_R_MAX_POS_Y)
+    {
+        state.racketRY += RACKET_R_SPEED;
+    }
+
+    if (state.win)
+    {
+        return None;
+    }
+
+    Collision collision = Intersect();
+
+    if (collision != LeftWindow && collision != RightWindow)
+    {
+        state.ballPosition.x += state.direction.x * state.ballSpeed;
+        state.ballPosition.y += state.direction.y * -1 * state.ballSpeed;
+        collision = Intersect();
+    }
+
+    switch (collision)
+    {
+    case TopRacketL:
+    case BottomRacketL:
+    case TopRacketR:
+    case BottomRacketR:
+        state.collisionCount++;
+
+        if (collision == TopRacketL || collision == BottomRacketL)
+        {
+            state.ballPosition.x = DEFAULT_RACKET_L_POS_X + RACKET_L_WIDTH;
+        }
+        else
+        {
+            state.ballPosition.x = DEFAULT_RACKET_R_POS_X - BALL_RADIUS * 2;
+        }
+
+        if (collision == TopRacketL || collision == TopRacketR)
+        {
+            state.direction = Vector2f(state.direction.x * -1.f, 0.5f);
+        }
+        else
+        {
+            state.direction = Vector2f(state.direction.x * -1.f, -0.5f);
+        }
+
+        // Increase the ball speed
+        state.ballSpeed = DEFAULT_BALL_SPEED + static_cast<float>(state.collisionCount) * BALL_SPEED_INCREASE_VALUE;
+        break;
+    case TopWindow:
+        state.ballPosition.y = 0;
+        state.direction.y *= -1;
+        break;
+    case BottomWindow:
+        state.ballPosition.y = WINDOW_HEIGHT - BALL_RADIUS * 2;
+        state.direction.y *= -1;
+        break;
+    case LeftWindow:
+        UpdateScore(PlayerRight);
+        break;
+    case RightWindow:
+        UpdateScore(PlayerLeft);
+        break;
+    default:
+        break;
+    }
+
+    return collision;
+}
+
+// Collision detection
+Collision Simulation::Intersect() const
+{
+    Collision collisionObject = None;
+
+    // Get ball coordinate values
+    const float ballMinX = state.ballPosition.x;
+    const float ballMinY = state.ballPosition.y;
+
+    const float ballMaxX = ballMinX + BALL_RADIUS * 2;
+    const float ballMaxY = ballMinY + BALL_RADIUS * 2;
+
+    // Get left racket coordinate values
+    const float racketLMinX = static_cast<float>(DEFAULT_RACKET_L_POS_X);
+    const float racketLMinY = state.racketLY;
+
+    const float racketLMaxX = racketLMinX + RACKET_L_WIDTH;
+    const float racketLMaxY = racketLMinY + RACKET_L_HEIGHT;
+
+    // Get right racket coordinate values
+    const float racketRMinX = static_cast<float>(DEFAULT_RACKET_R_POS_X);
+    const float racketRMinY = state.racketRY;
+
+    const float racketRMaxX = racketRMinX + RACKET_R_WIDTH;
+    const float racketRMaxY = racketRMinY + RACKET_R_HEIGHT;
+
+    /*
+    AABB algorithm (Axis-Aligned Bounding Boxes) in 2D
+    */
+
+    // Collision with left racket
+    if (ballMinX <= racketLMaxX && ballMaxX >= racketLMinX &&
+        ballMinY <= racketLMaxY && ballMaxY >= racketLMinY)
+    {
+        const float racketMiddleY = racketLMinY + RACKET_L_HEIGHT / 2.0f;
+
+        if (ballMaxY >= racketMiddleY)
+        {
+            collisionObject = BottomRacketL;
+        }
+        else
+        {
+            collisionObject = TopRacketL;
+        }
+    }
+    // Collision with right racket
+    else if (ballMinX <= racketRMaxX && ballMaxX >= racketRMinX &&
+        ballMinY <= racketRMaxY && ballMaxY >= racketRMinY)
+    {
+        const float racketMiddleY = racketRMinY + RACKET_R_HEIGHT / 2.0f;
+
+        if (ballMaxY >= racketMiddleY)
+        {
+            collisionObject = BottomRacketR;
+        }
+        else
+        {
+            collisionObject = TopRacketR;
+        }
+    }
+
+    // Collision between the ball and the top of the window
+    else if (ballMinY <= 0)
+    {
+        collisionObject = TopWindow;
+    }
+
+    // Collision between the ball and the bottom of the window
+    else if (ballMaxY >= WINDOW_HEIGHT)
+    {
+        collisionObject = BottomWindow;
+    }
+
+    // Collision between the ball and the right of the window
+    else if (ballMaxX >= WINDOW_WIDTH)
+    {
+        collisionObject = RightWindow;
+    }
+
+    // Collision between the ball and the left of the window
+    else if (ballMinX <= 0)
+    {
+        collisionObject = LeftWindow;
+    }
+
+    return collisionObject;
+}
+
+const Simulation::State& Simulation::GetState() const
+{
+    return state;
+}
+
+// Restore a snapshot taken with GetState()
+void Simulation::SetState(const State& newState)
+{
+    state = newState;
+}
+
+// Update the score and reset the ball and the rackets
+void Simulation::UpdateScore(Player player)
+{
+    if (player == PlayerLeft)
+    {
+        state.scoreL++;
+    }
+    else
+    {
+        state.scoreR++;
+    }
+
+    state.win = state.scoreL >= MAX_SCORE || state.scoreR >= MAX_SCORE;
+
+    state.ballPosition = Vector2f(static_cast<float>(DEFAULT_BALL_POS_X), static_cast<float>(DEFAULT_BALL_POS_Y));
+    state.ballSpeed = DEFAULT_BALL_SPEED;
+    state.racketLY = static_cast<float>(DEFAULT_RACKET_L_POS_Y);
+    state.racketRY = static_cast<float>(DEFAULT_RACKET_R_POS_Y);
+    state.collisionCount = 0;
+
+    Serve();
+}
+
+// Throws the ball to the default player if the total score is even, otherwise to the other player
+void Simulation::Serve()
+{
+    const bool toDefaultPlayer = (state.scoreL + state.scoreR) % 2 == 0;
+    const bool toLeft = (DEFAULT_PLAYER == PlayerLeft) == toDefaultPlayer;
+
+    state.direction = Vector2f(toLeft ? -1.f : 1.f, 0.f);
+}
@@ -0,0 +1,202 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "soak.h"
+
+#include "settings.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+Soak::Soak(float duration, float interval) : duration(duration), interval(interval), matches(0)
+{
+    // Reserved so the samples are not counted as a growing allocation
+    samples.reserve(static_cast<size_t>(duration / interval) + 2);
+
+    start = chrono::steady_clock::now();
+    lastSample = start;
+
+    // Initial state, before the first match
+    TakeSample(start);
+}
+
+void Soak::RecordFrame(double microseconds)
+{
+    frameHistogram.Record(microseconds);
+}
+
+void Soak::RecordTick(double microseconds)
+{
+    tickHistogram.Record(microseconds);
+}
+
+void Soak::AddMatch()
+{
+    matches++;
+}
+
+bool Soak::Update()
+{
+    const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+
+    if (chrono::duration<float>(now - lastSample).count() >= interval)
+    {
+        TakeSample(now);
+        lastSample = now;
+    }
+
+    return chrono::duration<float>(now - start).count() < duration;
+}
+
+void Soak::TakeSample(chrono::steady_clock::time_point now)
+{
+    Sample sample;
+    sample.elapsed = chrono::duration<double>(now - start).count();
+    sample.matches = matches;
+    sample.stats = GetProcessStats();
+    sample.tickP50 = tickHistogram.GetPercentile(50.);
+    sample.tickP99 = tickHistogram.GetPercentile(99.);
+    sample.frameP50 = frameHistogram.GetPercentile(50.);
+    sample.frameP99 = frameHistogram.GetPercentile(99.);
+    samples.push_back(sample);
+
+    tickHistogram.Reset();
+    frameHistogram.Reset();
+
+    cout << "Soak " << static_cast<int>(sample.elapsed) << " s : " << matches << " matches, "
+        << sample.stats.resident / 1024 << " KB resident, " << sample.stats.liveAllocations << " allocations, "
+        << sample.stats.handles << " handles, tick p99 " << sample.tickP99 << " us\n";
+}
+
+// Never decreases on most of the samples and ends significantly higher than it started.
+// Flat samples count as not decreasing, the minimum growth keeps a flat series with noise from being reported.
+bool Soak::IsGrowing(const vector<double>& values, size_t first) const
+{
+    if (values.size() < first + 3)
+    {
+        return false;
+    }
+
+    size_t increasing = 0;
+
+    for (size_t index = first + 1; index < values.size(); index++)
+    {
+        if (values[index] >= values[index - 1])
+        {
+            increasing++;
+        }
+    }
+
+    return values.back() > values[first] * (1. + SOAK_MIN_GROWTH) && increasing >= SOAK_MONOTONIC * static_cast<float>(values.size() - first - 1);
+}
+
+int Soak::Report(const string& fileName) const
+{
+    ofstream file(fileName);
+
+    if (file)
+    {
+        file << "elapsed_s,matches,resident_kb,allocations,live_allocations,live_bytes,handles,tick_p50_us,tick_p99_us,frame_p50_us,frame_p99_us\n";
+
+        for (const Sample& sample : samples)
+        {
+            file << sample.elapsed << ',' << sample.matches << ',' << sample.stats.resident / 1024 << ','
+                << sample.stats.allocations << ',' << sample.stats.liveAllocations << ',' << sample.stats.liveBytes << ','
+                << sample.stats.handles << ',' << sample.tickP50 << ',' << sample.tickP99 << ','
+                << sample.frameP50 << ',' << sample.frameP99 << '\n';
+        }
+    }
+    else
+    {
+        cout << "Cannot write " << fileName << '\n';
+    }
+
+    // The first sample is taken before the loop, it is only kept in the file
+    const size_t first = max<size_t>(1, static_cast<size_t>(SOAK_WARMUP * static_cast<float>(samples.size())));
+
+    if (samples.size() < first + 3)
+    {
+        cout << "Soak test too short to detect a drift (" << samples.size() << " samples)\n";
+        return 0;
+    }
+
+    vector<double> resident, liveAllocations, liveBytes, handles, tickP99;
+
+    for (const Sample& sample : samples)
+    {
+        resident.push_back(static_cast<double>(sample.stats.resident));
+        liveAllocations.push_back(static_cast<double>(sample.stats.liveAllocations));
+        liveBytes.push_back(static_cast<double>(sample.stats.liveBytes));
+        handles.push_back(static_cast<double>(sample.stats.handles));
+        tickP99.push_back(sample.tickP99);
+    }
+
+    const double hours = (samples.back().elapsed - samples[first].elapsed) / 3600.;
+    bool drift = false;
+
+    const auto check = [&](const string& name, const vector<double>& values)
+    {
+        const bool growing = IsGrowing(values, first);
+        drift = drift || growing;
+
+        cout << name << " : " << values[first] << " -> " << values.back();
+        if (hours > 0.)
+        {
+            cout << " (" << (values.back() - values[first]) / hours << " per hour)";
+        }
+        cout << (growing ? "  GROWING\n" : "\n");
+    };
+
+    cout << "\nSoak test : " << samples.back().matches << " matches in " << static_cast<int>(samples.back().elapsed) << " s\n";
+    check("Resident bytes", resident);
+
+    if (ALLOCATIONS_COUNTED)
+    {
+        check("Live allocations", liveAllocations);
+        check("Live bytes", liveBytes);
+    }
+    else
+    {
+        cout << "Live allocations : not counted (build with COUNT_ALLOCATIONS)\n";
+    }
+
+    check("Handles", handles);
+
+    // Median of the p99 of the first and of the last third
+    const auto median = [](vector<double> values)
+    {
+        nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    };
+
+    const size_t third = (tickP99.size() - first) / 3;
+    const double firstP99 = median(vector<double>(tickP99.begin() + first, tickP99.begin() + first + third));
+    const double lastP99 = median(vector<double>(tickP99.end() - third, tickP99.end()));
+    const bool creeping = lastP99 > firstP99 * SOAK_LATENCY_CREEP;
+    drift = drift || creeping;
+
+    cout << "Tick p99 : " << firstP99 << " us -> " << lastP99 << " us" << (creeping ? "  CREEPING\n" : "\n");
+
+    return drift ? 1 : 0;
+}
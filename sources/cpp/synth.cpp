@@ -0,0 +1,107 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "synth.h"
+
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+void Synth::Generate(const SynthPatch& patch, unsigned int sampleRate, vector<Int16>& samples)
+{
+    const float duration = patch.attack + patch.decay + patch.hold + patch.release;
+    const size_t count = static_cast<size_t>(duration * static_cast<float>(sampleRate));
+    const float step = patch.frequency / static_cast<float>(sampleRate);
+    const float timeStep = 1.f / static_cast<float>(sampleRate);
+
+    samples.resize(count);
+
+    // Phase in cycles, from 0 to 1
+    float phase = 0.f;
+    // Same noise every time, so the effects don't change between runs
+    uint32_t noise = 1;
+
+    for (size_t index = 0; index < count; index++)
+    {
+        float value = 0.f;
+
+        switch (patch.waveform)
+        {
+        case Sine:
+            value = sin(2.f * numbers::pi_v<float> * phase);
+            break;
+        case Square:
+            value = phase < 0.5f ? 1.f : -1.f;
+            break;
+        case Triangle:
+            value = 1.f - 4.f * abs(phase - 0.5f);
+            break;
+        case Noise:
+            noise = noise * 1664525u + 1013904223u;
+            value = static_cast<float>(static_cast<int32_t>(noise)) / 2147483648.f;
+            break;
+        }
+
+        const float level = value * Envelope(patch, static_cast<float>(index) * timeStep) * patch.amplitude;
+        samples[index] = static_cast<Int16>(level * 32767.f);
+
+        phase += step;
+        if (phase >= 1.f)
+        {
+            phase -= 1.f;
+        }
+    }
+}
+
+bool Synth::Generate(const SynthPatch& patch, unsigned int sampleRate, SoundBuffer& buffer)
+{
+    vector<Int16> samples;
+    Generate(patch, sampleRate, samples);
+
+    return buffer.loadFromSamples(samples.data(), samples.size(), 1, sampleRate);
+}
+
+// Linear attack, decay and release
+float Synth::Envelope(const SynthPatch& patch, float time)
+{
+    if (time < patch.attack)
+    {
+        return time / patch.attack;
+    }
+    time -= patch.attack;
+
+    if (time < patch.decay)
+    {
+        return 1.f - (1.f - patch.sustain) * time / patch.decay;
+    }
+    time -= patch.decay;
+
+    if (time < patch.hold)
+    {
+        return patch.sustain;
+    }
+    time -= patch.hold;
+
+    return time < patch.release ? patch.sustain * (1.f - time / patch.release) : 0.f;
+}
@@ -0,0 +1,130 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "threadpool.h"
+
+#include <algorithm>
+
+// Constructor, 0 uses one thread per core
+ThreadPool::ThreadPool(unsigned int threads)
+{
+    if (threads == 0)
+    {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+
+    threadCount = threads;
+
+    // The calling thread works too
+    for (unsigned int index = 1; index < threads; index++)
+    {
+        workers.emplace_back(&ThreadPool::Work, this, index);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(taskMutex);
+        stop = true;
+    }
+    wakeCondition.notify_all();
+
+    for (thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+unsigned int ThreadPool::GetThreadCount() const
+{
+    return threadCount;
+}
+
+void ThreadPool::Run(size_t count, TaskFunction function, void* context)
+{
+    if (threadCount == 1)
+    {
+        function(context, 0, count);
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(taskMutex);
+        task = function;
+        taskContext = context;
+        taskCount = count;
+        pending = threadCount - 1;
+        generation++;
+    }
+    wakeCondition.notify_all();
+
+    // First slice on the calling thread
+    const size_t end = count / threadCount;
+    if (end > 0)
+    {
+        function(context, 0, end);
+    }
+
+    unique_lock<mutex> lock(taskMutex);
+    doneCondition.wait(lock, [this] { return pending == 0; });
+}
+
+void ThreadPool::Work(size_t index)
+{
+    unsigned long long seen = 0;
+    unique_lock<mutex> lock(taskMutex);
+
+    while (true)
+    {
+        wakeCondition.wait(lock, [this, seen] { return stop || generation != seen; });
+
+        if (stop)
+        {
+            return;
+        }
+
+        seen = generation;
+
+        const TaskFunction function = task;
+        void* context = taskContext;
+        const size_t count = taskCount;
+        const size_t begin = count * index / threadCount;
+        const size_t end = count * (index + 1) / threadCount;
+
+        lock.unlock();
+
+        if (begin < end)
+        {
+            function(context, begin, end);
+        }
+
+        lock.lock();
+
+        if (--pending == 0)
+        {
+            doneCondition.notify_one();
+        }
+    }
+}
@@ -0,0 +1,241 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "trace.h"
+
+#include "settings.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+atomic<bool> Trace::enabled{ false };
+mutex Trace::buffersMutex;
+vector<unique_ptr<Trace::ThreadBuffer>>* Trace::buffers = new vector<unique_ptr<Trace::ThreadBuffer>>();
+
+static const chrono::steady_clock::time_point origin = chrono::steady_clock::now();
+
+// Constructor
+Trace::Span::Span(const char* name)
+    : name(name), start(enabled.load(memory_order_relaxed) ? Now() : 0)
+{
+}
+
+Trace::Span::~Span()
+{
+    if (start != 0)
+    {
+        Event event;
+        event.name = name;
+        event.timestamp = start;
+        event.duration = Now() - start;
+        event.type = CompleteEvent;
+        Write(event);
+    }
+}
+
+void Trace::Enable(bool value)
+{
+    enabled.store(value);
+}
+
+bool Trace::IsEnabled()
+{
+    return enabled.load(memory_order_relaxed);
+}
+
+// Name of the current thread, kept until its buffer is created
+static thread_local const char* threadName = nullptr;
+
+// Name shown for the current thread in the viewer, the buffer is not created while tracing is disabled
+void Trace::SetThreadName(const char* name)
+{
+    threadName = name;
+
+    if (IsEnabled())
+    {
+        GetBuffer().name = name;
+    }
+}
+
+void Trace::Complete(const char* name, chrono::steady_clock::time_point start, chrono::steady_clock::time_point end)
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.timestamp = ToNanoseconds(start);
+    event.duration = ToNanoseconds(end) - event.timestamp;
+    event.type = CompleteEvent;
+    Write(event);
+}
+
+void Trace::Instant(const char* name)
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.timestamp = Now();
+    event.duration = 0;
+    event.type = InstantEvent;
+    Write(event);
+}
+
+void Trace::Counter(const char* name, double value)
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.timestamp = Now();
+    event.value = value;
+    event.type = CounterEvent;
+    Write(event);
+}
+
+// Write the last events of every thread as JSON
+bool Trace::SaveToFile(const string& fileName)
+{
+    ofstream file(fileName);
+
+    if (!file)
+    {
+        cerr << "Error writing trace file: " << fileName << "\n";
+        return false;
+    }
+
+    lock_guard<mutex> lock(buffersMutex);
+    char line[256];
+    bool first = true;
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    for (const unique_ptr<ThreadBuffer>& buffer : *buffers)
+    {
+        const size_t capacity = buffer->events.size();
+
+        if (buffer->name)
+        {
+            snprintf(line, sizeof(line), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", buffer->id, buffer->name);
+            file << line;
+            first = false;
+        }
+
+        // The owner may keep writing: copy the readable part of the ring, then drop what was overwritten meanwhile
+        const unsigned long long end = buffer->written.load(memory_order_acquire);
+        const unsigned long long begin = end > capacity ? end - capacity : 0;
+        vector<Event> events(static_cast<size_t>(end - begin));
+
+        for (unsigned long long index = begin; index < end; index++)
+        {
+            events[static_cast<size_t>(index - begin)] = buffer->events[index % capacity];
+        }
+
+        // The owner writes slot after % capacity before publishing after + 1, so the copy of that slot may be torn too
+        const unsigned long long after = buffer->written.load(memory_order_acquire);
+        const unsigned long long valid = after + 1 > capacity ? after + 1 - capacity : 0;
+
+        for (unsigned long long index = max(begin, valid); index < end; index++)
+        {
+            const Event& event = events[static_cast<size_t>(index - begin)];
+            const double timestamp = event.timestamp / 1000.0;
+
+            switch (event.type)
+            {
+            case CompleteEvent:
+                snprintf(line, sizeof(line), "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    first ? "" : ",\n", event.name, buffer->id, timestamp, event.duration / 1000.0);
+                break;
+            case InstantEvent:
+                snprintf(line, sizeof(line), "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                    first ? "" : ",\n", event.name, buffer->id, timestamp);
+                break;
+            case CounterEvent:
+                snprintf(line, sizeof(line), "%s{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%g}}",
+                    first ? "" : ",\n", event.name, buffer->id, timestamp, event.value);
+                break;
+            }
+
+            file << line;
+            first = false;
+        }
+    }
+
+    file << "\n]}\n";
+
+    return true;
+}
+
+long long Trace::Now()
+{
+    return ToNanoseconds(chrono::steady_clock::now());
+}
+
+long long Trace::ToNanoseconds(chrono::steady_clock::time_point time)
+{
+    // 0 means "not traced" for a span
+    return max(1LL, static_cast<long long>(chrono::duration_cast<chrono::nanoseconds>(time - origin).count()));
+}
+
+// Buffer of the current thread, created at its first event
+Trace::ThreadBuffer& Trace::GetBuffer()
+{
+    thread_local ThreadBuffer* buffer = nullptr;
+
+    if (!buffer)
+    {
+        unique_ptr<ThreadBuffer> created(new ThreadBuffer());
+        created->name = threadName;
+        created->events.resize(TRACE_BUFFER_EVENTS);
+        created->written.store(0);
+
+        lock_guard<mutex> lock(buffersMutex);
+        created->id = static_cast<unsigned int>(buffers->size() + 1);
+        buffer = created.get();
+        buffers->push_back(move(created));
+    }
+
+    return *buffer;
+}
+
+void Trace::Write(const Event& event)
+{
+    ThreadBuffer& buffer = GetBuffer();
+    const unsigned long long index = buffer.written.load(memory_order_relaxed);
+
+    buffer.events[index % buffer.events.size()] = event;
+    buffer.written.store(index + 1, memory_order_release);
+}
@@ -0,0 +1,114 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include "usage.h"
+#include "process.h"
+
+#include <cstdio>
+
+const char* const STATE_NAMES[UsageMeter::StateCount]{ "Playing", "Paused", "Won" };
+
+UsageMeter::UsageMeter() : state(Playing), start(chrono::steady_clock::now()), cpuStart(GetCpuTime()), energyStart(0.0), usages{}
+{
+    hasEnergy = GetPackageEnergy(energyStart);
+}
+
+void UsageMeter::SetState(State newState)
+{
+    if (newState == state)
+    {
+        return;
+    }
+
+    const Usage current = GetCurrent();
+    usages[state].seconds += current.seconds;
+    usages[state].cpuSeconds += current.cpuSeconds;
+    usages[state].joules += current.joules;
+
+    state = newState;
+    start = chrono::steady_clock::now();
+    cpuStart = GetCpuTime();
+    hasEnergy = hasEnergy && GetPackageEnergy(energyStart);
+}
+
+void UsageMeter::AddFrame()
+{
+    usages[state].frames++;
+}
+
+// The processor time is a percentage of one core, the power is the one of the whole processor package
+void UsageMeter::Report(ostream& stream) const
+{
+    const Usage current = GetCurrent();
+    char line[200];
+
+    for (unsigned int index = 0; index < StateCount; index++)
+    {
+        Usage usage = usages[index];
+
+        if (index == state)
+        {
+            usage.seconds += current.seconds;
+            usage.cpuSeconds += current.cpuSeconds;
+            usage.joules += current.joules;
+        }
+
+        if (usage.seconds <= 0.0)
+        {
+            continue;
+        }
+
+        char power[32] = "n/a";
+        if (hasEnergy)
+        {
+            snprintf(power, sizeof(power), "%.2f W", usage.joules / usage.seconds);
+        }
+
+        snprintf(line, sizeof(line), "%-12s time %9.1f s  frames %-9llu fps %7.1f  cpu %6.1f %%  power %s",
+            STATE_NAMES[index], usage.seconds, usage.frames, usage.frames / usage.seconds, usage.cpuSeconds / usage.seconds * 100.0, power);
+        stream << line << "\n";
+    }
+
+    if (!hasEnergy)
+    {
+        stream << "             power needs the RAPL counters of Linux (see README)\n";
+    }
+}
+
+UsageMeter::Usage UsageMeter::GetCurrent() const
+{
+    Usage current{};
+    current.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    current.cpuSeconds = GetCpuTime() - cpuStart;
+
+    double energy = 0.0;
+    // The counter wraps around, a negative difference is dropped
+    if (hasEnergy && GetPackageEnergy(energy) && energy >= energyStart)
+    {
+        current.joules = energy - energyStart;
+    }
+
+    return current;
+}
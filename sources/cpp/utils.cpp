@@ -24,19 +24,25 @@
 
 #include "utils.h"
 
-#include <iostream>
-
 void SetText(Text& text, const String& str)
 {
     text.setString(str);
 }
 
-// Load a sound from file
-bool LoadSound(SoundBuffer& buffer, const string& fileName)
+void SetText(HudText& text, const String& str)
 {
-    if (!buffer.loadFromFile(fileName)) {
-        cerr << "Error loading sound file: " << fileName << "\n";
-        return false;
+    text.SetString(str);
+}
+
+// Load a font from the archive, or from file if it is not packed.
+// The font reads the archive while it is used, the archive must stay open.
+bool LoadFont(Font& font, const Archive& archive, const string& fileName)
+{
+    const Archive::Entry entry = archive.Find(fileName);
+
+    if (!entry.data)
+    {
+        return font.loadFromFile(fileName);
     }
-    return true;
+    return font.loadFromMemory(entry.data, entry.size);
 }
\ No newline at end of file
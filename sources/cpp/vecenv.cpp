@@ -0,0 +1,104 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "vecenv.h"
+
+// Constructor
+VecEnv::VecEnv(size_t count, unsigned int threads)
+    : simulations(count), pool(threads)
+{
+}
+
+size_t VecEnv::GetCount() const
+{
+    return simulations.size();
+}
+
+unsigned int VecEnv::GetThreadCount() const
+{
+    return pool.GetThreadCount();
+}
+
+const Simulation::State& VecEnv::GetState(size_t index) const
+{
+    return simulations[index].GetState();
+}
+
+// Start new matches everywhere
+void VecEnv::Reset(float* observations)
+{
+    for (size_t index = 0; index < simulations.size(); index++)
+    {
+        simulations[index].Reset();
+        Observe(simulations[index].GetState(), observations + index * OBSERVATION_SIZE);
+    }
+}
+
+void VecEnv::Step(const unsigned char* actions, float* observations, float* rewards, unsigned char* dones)
+{
+    auto task = [&](size_t begin, size_t end)
+    {
+        for (size_t index = begin; index < end; index++)
+        {
+            Simulation& simulation = simulations[index];
+            const unsigned char actionL = actions[index * ACTION_SIZE];
+            const unsigned char actionR = actions[index * ACTION_SIZE + 1];
+
+            // Same buttons as the keyboard
+            Input::Button button{};
+            button.Z = actionL == ActionUp;
+            button.S = actionL == ActionDown;
+            button.up = actionR == ActionUp;
+            button.down = actionR == ActionDown;
+
+            const Collision collision = simulation.Step(button);
+
+            float* reward = rewards + index * REWARD_SIZE;
+            reward[0] = collision == RightWindow ? 1.f : collision == LeftWindow ? -1.f : 0.f;
+            reward[1] = -reward[0];
+
+            dones[index] = simulation.GetState().win ? 1 : 0;
+
+            if (dones[index])
+            {
+                simulation.Reset();
+            }
+
+            Observe(simulation.GetState(), observations + index * OBSERVATION_SIZE);
+        }
+    };
+
+    pool.ParallelFor(simulations.size(), task);
+}
+
+void VecEnv::Observe(const Simulation::State& state, float* observation)
+{
+    observation[0] = state.ballPosition.x;
+    observation[1] = state.ballPosition.y;
+    observation[2] = state.direction.x;
+    observation[3] = state.direction.y;
+    observation[4] = state.ballSpeed;
+    observation[5] = state.racketLY;
+    observation[6] = state.racketRY;
+}
@@ -0,0 +1,159 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include "viewport.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// The scale is lowered when the average frame exceeds its budget by this ratio
+const double VIEWPORT_OVERLOAD_RATIO{ 1.15 };
+// Frames longer than this number of budgets (loading, serve pause, window moved) are not caused by the rendering
+const double VIEWPORT_HITCH_RATIO{ 4.0 };
+const double VIEWPORT_AVERAGE_WEIGHT{ 0.1 };
+const unsigned int VIEWPORT_MAX_PROBE_FACTOR{ 16 };
+
+Viewport::Viewport(Vector2f logicalSize, float minimumScale, float scaleStep, unsigned int probeFrames)
+    : logicalSize(logicalSize), minimumScale(minimumScale), scaleStep(scaleStep), probeFrames(max(1u, probeFrames)),
+    level(0), averageFrame(0.0), stableFrames(0), probeInterval(max(1u, probeFrames)), probing(false)
+{
+    maxLevel = scaleStep > 0.f ? static_cast<unsigned int>(floor((1.f - minimumScale) / scaleStep + 0.001f)) : 0;
+}
+
+bool Viewport::Resize(Vector2u newSize)
+{
+    outputSize = Vector2u(max(1u, newSize.x), max(1u, newSize.y));
+
+    // Largest size of the logical ratio inside the output, centered
+    const float fit = min(outputSize.x / logicalSize.x, outputSize.y / logicalSize.y);
+    const float width = floor(logicalSize.x * fit);
+    const float height = floor(logicalSize.y * fit);
+    letterbox = FloatRect(floor((outputSize.x - width) / 2.f), floor((outputSize.y - height) / 2.f), width, height);
+
+    return CreateScene();
+}
+
+bool Viewport::Update(double frameMicroseconds, double budgetMicroseconds)
+{
+    if (budgetMicroseconds <= 0.0 || frameMicroseconds > budgetMicroseconds * VIEWPORT_HITCH_RATIO)
+    {
+        return false;
+    }
+
+    averageFrame = averageFrame == 0.0 ? frameMicroseconds : averageFrame + (frameMicroseconds - averageFrame) * VIEWPORT_AVERAGE_WEIGHT;
+
+    if (averageFrame > budgetMicroseconds * VIEWPORT_OVERLOAD_RATIO)
+    {
+        // The last higher resolution was too slow, it is tried less often
+        if (probing)
+        {
+            probeInterval = min(probeInterval * 2, probeFrames * VIEWPORT_MAX_PROBE_FACTOR);
+            probing = false;
+        }
+
+        // Starts again from the budget so the next step is measured at the new scale
+        averageFrame = budgetMicroseconds;
+        stableFrames = 0;
+
+        if (level < maxLevel)
+        {
+            level++;
+            CreateScene();
+            return true;
+        }
+
+        return false;
+    }
+
+    stableFrames++;
+
+    if (probing && stableFrames >= probeFrames)
+    {
+        probeInterval = probeFrames;
+        probing = false;
+    }
+
+    if (level > 0 && stableFrames >= probeInterval)
+    {
+        level--;
+        probing = true;
+        stableFrames = 0;
+        CreateScene();
+        return true;
+    }
+
+    return false;
+}
+
+RenderTexture& Viewport::GetScene()
+{
+    return scene;
+}
+
+void Viewport::Present(RenderTarget& output)
+{
+    output.setView(View(FloatRect(0.f, 0.f, static_cast<float>(outputSize.x), static_cast<float>(outputSize.y))));
+    output.draw(sprite);
+}
+
+View Viewport::GetLetterboxView() const
+{
+    View view(FloatRect(0.f, 0.f, logicalSize.x, logicalSize.y));
+    view.setViewport(FloatRect(letterbox.left / outputSize.x, letterbox.top / outputSize.y, letterbox.width / outputSize.x, letterbox.height / outputSize.y));
+    return view;
+}
+
+float Viewport::GetScale() const
+{
+    return 1.f - scaleStep * level;
+}
+
+Vector2u Viewport::GetSceneSize() const
+{
+    return scene.getSize();
+}
+
+bool Viewport::CreateScene()
+{
+    const float scale = GetScale();
+    const Vector2u size(max(1u, static_cast<unsigned int>(letterbox.width * scale)), max(1u, static_cast<unsigned int>(letterbox.height * scale)));
+
+    if (size != scene.getSize() && !scene.create(size.x, size.y))
+    {
+        return false;
+    }
+
+    // Creating the texture resets its view
+    scene.setView(View(FloatRect(0.f, 0.f, logicalSize.x, logicalSize.y)));
+    scene.setSmooth(true);
+
+    sprite.setTexture(scene.getTexture(), true);
+    sprite.setPosition(letterbox.left, letterbox.top);
+    sprite.setScale(letterbox.width / size.x, letterbox.height / size.y);
+
+    return true;
+}
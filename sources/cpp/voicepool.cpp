@@ -0,0 +1,157 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "voicepool.h"
+
+#include "settings.h"
+
+#include <algorithm>
+#include <cmath>
+
+VoicePool::VoicePool(unsigned int voiceCount) : voices(voiceCount), stats{}
+{
+    for (Voice& voice : voices)
+    {
+        // The position is a direction around the listener, the distance doesn't change the volume
+        voice.sound.setRelativeToListener(true);
+        voice.sound.setAttenuation(0.f);
+        voice.priority = 0;
+    }
+}
+
+unsigned int VoicePool::AddEffect(const SoundBuffer& buffer, float volume, unsigned int priority, float minInterval)
+{
+    Effect& effect = effects.emplace_back();
+
+    // OpenAL only spatializes mono sounds
+    if (buffer.getChannelCount() == 2)
+    {
+        const Int16* samples = buffer.getSamples();
+        const size_t frameCount = static_cast<size_t>(buffer.getSampleCount() / 2);
+        vector<Int16> mono(frameCount);
+
+        for (size_t frame = 0; frame < frameCount; frame++)
+        {
+            mono[frame] = static_cast<Int16>((static_cast<int>(samples[frame * 2]) + samples[frame * 2 + 1]) / 2);
+        }
+        effect.buffer.loadFromSamples(mono.data(), mono.size(), 1, buffer.getSampleRate());
+    }
+    else
+    {
+        effect.buffer = buffer;
+    }
+
+    effect.volume = volume;
+    effect.priority = priority;
+    effect.length = chrono::duration_cast<chrono::steady_clock::duration>(chrono::microseconds(effect.buffer.getDuration().asMicroseconds()));
+    effect.minInterval = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<float>(minInterval));
+    effect.lastPlay = chrono::steady_clock::time_point::min();
+
+    return static_cast<unsigned int>(effects.size() - 1);
+}
+
+bool VoicePool::Play(unsigned int effect, float x, float pitch)
+{
+    Effect& played = effects[effect];
+    const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+
+    if (played.lastPlay != chrono::steady_clock::time_point::min() && now - played.lastPlay < played.minInterval)
+    {
+        stats.rateLimited++;
+        return false;
+    }
+
+    const size_t index = FindVoice(played.priority, now);
+
+    if (index == voices.size())
+    {
+        stats.dropped++;
+        return false;
+    }
+
+    Voice& voice = voices[index];
+
+    if (voice.end > now)
+    {
+        stats.steals++;
+        voice.sound.stop();
+    }
+
+    // -1 on the left of the window, 1 on the right
+    const float pan = clamp((x / static_cast<float>(WINDOW_WIDTH) * 2.f - 1.f) * SOUND_PAN, -1.f, 1.f);
+
+    if (voice.sound.getBuffer() != &played.buffer)
+    {
+        voice.sound.setBuffer(played.buffer);
+    }
+    voice.sound.setVolume(played.volume);
+    voice.sound.setPitch(pitch);
+    voice.sound.setPosition(pan, 0.f, -sqrt(1.f - pan * pan));
+    voice.sound.play();
+
+    voice.priority = played.priority;
+    // A higher pitch plays the buffer faster
+    voice.end = now + chrono::duration_cast<chrono::steady_clock::duration>(played.length / pitch);
+    played.lastPlay = now;
+    stats.plays++;
+
+    return true;
+}
+
+void VoicePool::StopAll()
+{
+    for (Voice& voice : voices)
+    {
+        voice.sound.stop();
+        voice.end = chrono::steady_clock::time_point();
+    }
+}
+
+const VoicePool::Stats& VoicePool::GetStats() const
+{
+    return stats;
+}
+
+// A free voice, else the voice of the lowest priority that ends first, if it is not above the new sound
+size_t VoicePool::FindVoice(unsigned int priority, chrono::steady_clock::time_point now)
+{
+    size_t victim = voices.size();
+
+    for (size_t index = 0; index < voices.size(); index++)
+    {
+        const Voice& voice = voices[index];
+
+        if (voice.end <= now)
+        {
+            return index;
+        }
+
+        if (voice.priority <= priority && (victim == voices.size() || voice.priority < voices[victim].priority
+            || (voice.priority == voices[victim].priority && voice.end < voices[victim].end)))
+        {
+            victim = index;
+        }
+    }
+    return victim;
+}
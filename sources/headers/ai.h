@@ -0,0 +1,56 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "input.h"
+#include "settings.h"
+#include <random>
+#include <SFML/System.hpp>
+
+using namespace sf;
+
+// Computer player: predicts where the ball will reach its racket at each bounce and moves toward it
+class AI
+{
+public:
+    // Functions
+    AI(Player side, unsigned int reactionDelay, float aimError, unsigned int seed = 0);
+    void Reset();
+    void Observe(Collision collision, Vector2f ballPosition, Vector2f direction, float speed);
+    void Control(Input::Button& button, float racketY);
+    float GetTarget() const;
+
+    static float PredictBallY(Vector2f ballPosition, Vector2f direction, float speed, float targetX);
+
+private:
+    Player side;
+    unsigned int reactionDelay;
+    float aimError;
+    mt19937 random;
+
+    bool hasPrediction;
+    unsigned int waitFrames;
+    float target;
+};
\ No newline at end of file
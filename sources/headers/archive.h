@@ -0,0 +1,74 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+// Assets packed in one indexed file, mapped in memory so they are loaded without copy or extra open.
+// Created by "Pong --pack-assets" after each build, next to the executable.
+class Archive
+{
+public:
+    struct Entry
+    {
+        // nullptr if the archive doesn't contain the file
+        const unsigned char* data;
+        size_t size;
+    };
+
+    // Functions
+    Archive();
+    ~Archive();
+    Archive(const Archive&) = delete;
+    Archive& operator=(const Archive&) = delete;
+    // Map the archive, false if it is missing or corrupted
+    bool Open(const string& fileName);
+    void Close();
+    bool IsOpen() const;
+    // The name is the path used without archive, like "assets/CodeNewRoman.otf"
+    Entry Find(const string& name) const;
+    size_t GetEntryCount() const;
+    // Pack the files of a directory, named as if it was the assets directory
+    static bool Pack(const string& directory, const string& fileName);
+
+private:
+    const unsigned char* data;
+    size_t size;
+    unordered_map<string, Entry> entries;
+#if defined(_WIN32)
+    void* file;
+    void* mapping;
+#endif
+
+    bool ReadIndex();
+};
+
+// Directory of the executable with a trailing separator, the assets are found wherever the game is started from
+string GetExecutableDirectory();
+int RunPackAssets(int argc, char* argv[]);
@@ -0,0 +1,82 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Loads the assets on worker threads while the window shows the loading screen.
+// Each asset is a function returning false on error, its result is given by a future.
+class AssetLoader
+{
+public:
+    struct Timing
+    {
+        // String literal, also used as the name of the trace span
+        const char* name;
+        // Since the creation of the loader (in milliseconds)
+        double start;
+        double end;
+        bool loaded;
+    };
+
+    // Functions
+    // 0 uses one thread per core
+    explicit AssetLoader(unsigned int threads = 0);
+    ~AssetLoader();
+    future<bool> Load(const char* name, function<bool()> load);
+    size_t GetAssetCount() const;
+    size_t GetLoadedCount() const;
+    bool IsDone() const;
+    // Timings of the finished assets
+    vector<Timing> GetTimings() const;
+
+private:
+    struct Job
+    {
+        const char* name;
+        function<bool()> load;
+        promise<bool> result;
+    };
+
+    chrono::steady_clock::time_point start;
+    vector<thread> workers;
+    mutable mutex jobsMutex;
+    condition_variable wakeCondition;
+    deque<Job> jobs;
+    vector<Timing> timings;
+    size_t assetCount = 0;
+    bool stop = false;
+
+    void Work();
+};
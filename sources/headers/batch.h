@@ -0,0 +1,43 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <string>
+
+using namespace std;
+
+// Play AI vs AI matches without window and print the results.
+// With search, the left racket is played by the search AI against the predictive AI.
+// If histogramFile is not empty, the time of each frame is saved in it.
+int RunBatch(unsigned int matches, bool search = false, const string& histogramFile = "");
+
+// Measure the number of VecEnv steps per second
+int RunVecEnv(unsigned int envs, unsigned int steps, unsigned int threads);
+
+// Play a learned policy against itself on many matches, evaluated in batch at each step
+int RunPolicy(const string& fileName, unsigned int matches, unsigned int steps);
+
+// Merge histograms saved by several runs and print the percentiles
+int RunHistogramMerge(int argc, char* argv[]);
\ No newline at end of file
@@ -0,0 +1,58 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct BenchmarkResult
+{
+    string name;
+    // Nanoseconds per operation of each repetition
+    vector<double> samples;
+    double mean;
+    double stddev;
+    double min;
+    double max;
+    unsigned long long iterations;
+};
+
+// Run the benchmarks whose name contains filter, each one repeated after a warmup.
+// The names of the benchmarks that could not be measured are added to failed.
+vector<BenchmarkResult> RunBenchmarks(const string& filter, unsigned int repetitions, vector<string>& failed);
+bool SaveBenchmarks(const vector<BenchmarkResult>& results, const string& fileName);
+// Read the names and samples of a file written by SaveBenchmarks(), false if it has no benchmark or can't be parsed
+bool LoadBenchmarks(vector<BenchmarkResult>& results, const string& fileName);
+void PrintBenchmarks(const vector<BenchmarkResult>& results);
+
+// Command line: --bench [--filter name] [--repetitions count] [--json file]
+int RunBench(int argc, char* argv[]);
+
+// Command line: --bench-compare [--profile name] [--runs count] [--filter name] [--threshold percent] [--update]
+// Compare the benchmarks to the baseline of the machine profile, exits with 1 if one is significantly slower
+int RunBenchCompare(int argc, char* argv[]);
\ No newline at end of file
@@ -0,0 +1,116 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "input.h"
+#include "settings.h"
+#include "simulation.h"
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// Writes values of any number of bits (up to 32) one after the other, starting with the low bits of each byte
+class BitWriter
+{
+public:
+    // Functions
+    explicit BitWriter(unsigned char* buffer);
+    void Write(uint32_t value, unsigned int bits);
+    // Write the last partial byte, returns the size in bytes
+    size_t Finish();
+
+private:
+    unsigned char* buffer;
+    size_t size;
+    uint64_t pending;
+    unsigned int pendingBits;
+};
+
+class BitReader
+{
+public:
+    // Functions
+    BitReader(const unsigned char* buffer, size_t size);
+    uint32_t Read(unsigned int bits);
+    // False if more bits were read than the buffer contains, or a value was out of its range
+    bool IsValid() const;
+    void Invalidate();
+
+private:
+    const unsigned char* buffer;
+    size_t size;
+    size_t position;
+    uint64_t pending;
+    unsigned int pendingBits;
+    bool valid;
+};
+
+// Number of bits needed to store the values from 0 to value
+constexpr unsigned int GetBitCount(unsigned int value)
+{
+    return value == 0 ? 0 : 1 + GetBitCount(value >> 1);
+}
+
+// Bits of each field of the quantized state
+// Ball position: 1/8 pixel, from -64 pixels to 960 pixels (the arena with a margin)
+const unsigned int BALL_POSITION_BITS{ 13 };
+const float BALL_POSITION_SCALE{ 8.f };
+const float BALL_POSITION_OFFSET{ 64.f };
+// Direction: index in a table of 8 angles
+const unsigned int DIRECTION_BITS{ 3 };
+// Ball speed: 1/32 pixel per frame, up to 64
+const unsigned int BALL_SPEED_BITS{ 11 };
+const float BALL_SPEED_SCALE{ 32.f };
+// Racket: whole pixels, from -16
+const unsigned int RACKET_BITS{ 10 };
+const int RACKET_OFFSET{ 16 };
+const unsigned int SCORE_BITS{ GetBitCount(MAX_SCORE) };
+// Z, S, up, down, escape and space
+const unsigned int BUTTON_BITS{ 6 };
+
+// Fields of the state, each one has a bit in the mask of a delta
+const unsigned int STATE_FIELD_COUNT{ 9 };
+
+// Bits of a whole state
+const unsigned int STATE_BITS{ BALL_POSITION_BITS * 2 + DIRECTION_BITS + BALL_SPEED_BITS + RACKET_BITS * 2 + SCORE_BITS * 2 + 1 };
+
+// Write all the fields of the state
+void EncodeState(BitWriter& writer, const Simulation::State& state);
+// A score above MAX_SCORE invalidates the reader
+void DecodeState(BitReader& reader, Simulation::State& state);
+// Write a mask of the fields that changed since the previous state, then these fields
+void EncodeStateDelta(BitWriter& writer, const Simulation::State& previous, const Simulation::State& state);
+// Apply the changed fields to the state
+void DecodeStateDelta(BitReader& reader, Simulation::State& state);
+// State as it is after an encoding and a decoding. The ball speed and the collision count are exact, the ball position
+// is rounded to 1/8 pixel.
+Simulation::State QuantizeState(const Simulation::State& state);
+
+void EncodeButtons(BitWriter& writer, const Input::Button& button);
+Input::Button DecodeButtons(BitReader& reader);
+
+// --codec-fuzz [iterations] : random states, deltas and corrupted packets are encoded and decoded, returns 1 on a mismatch
+int RunCodecFuzz(int argc, char* argv[]);
@@ -0,0 +1,59 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "input.h"
+#include "simulation.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Size of a state serialized by SerializeState
+const size_t STATE_SIZE{ 41 };
+
+// Canonical serialization: each field in a fixed order and little-endian, so the bytes only depend on the values
+void SerializeState(const Simulation::State& state, unsigned char* bytes);
+Simulation::State DeserializeState(const unsigned char* bytes);
+// xxHash of the canonical serialization
+unsigned long long HashState(const Simulation::State& state);
+
+// Buttons of the rackets in 4 bits (Z, S, up, down)
+unsigned char PackInput(const Input::Button& button);
+Input::Button UnpackInput(unsigned char input);
+
+// Inputs of AI vs AI matches, replayed by the determinism checks
+vector<unsigned char> GenerateInputs(unsigned int ticks, unsigned int seed);
+// State after each input, a new match is started when one is won
+vector<Simulation::State> ReplayInputs(const vector<unsigned char>& inputs);
+
+// Compare the states tick by tick, print the fields of the first diverging tick and return its index (-1 if none)
+long long FindDivergence(const vector<Simulation::State>& expected, const vector<Simulation::State>& actual);
+
+// --determinism [ticks] [seed] : replays the same inputs on two simulations, the second on another thread
+// --determinism-record file [ticks] [seed] : saves the inputs and the state of each tick
+// --determinism-verify file : replays a recorded file, from another build for example
+// Returns 1 if the runs diverge
+int RunDeterminism(int argc, char* argv[]);
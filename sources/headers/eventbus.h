@@ -0,0 +1,114 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "settings.h"
+#include <SFML/System.hpp>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+using namespace sf;
+using namespace std;
+
+// Outcome of the simulation, consumed by the audio, the HUD and the telemetry
+struct GameEvent
+{
+    enum Type : unsigned char { RacketHit, WallHit, Scored, MatchWon, MatchReset, Paused };
+
+    Type type;
+    // RacketHit : side of the racket, Scored and MatchWon : player who scored
+    Player player;
+    // RacketHit : top half of the racket, WallHit : top wall, Paused : game paused
+    bool top;
+    // Center of the ball
+    Vector2f position;
+    float ballSpeed;
+    unsigned int scoreL;
+    unsigned int scoreR;
+    // Racket hits of the rally
+    unsigned int rally;
+};
+
+// Events published by any thread without lock, each subscriber has its own queue and
+// reads it when it wants. Publishing never waits: if a queue is full, the event is dropped for that subscriber.
+class EventBus
+{
+public:
+    // Functions
+    // The capacity is rounded up to a power of two
+    explicit EventBus(size_t capacity);
+    // Only before the first event is published, returns the id of the queue of the subscriber
+    unsigned int Subscribe();
+    // False if the event was dropped by a subscriber
+    bool Publish(const GameEvent& event);
+    unsigned long long GetDroppedCount() const;
+
+    // Call handler(event) for each event of the subscriber in the order they were published.
+    // Only one thread may poll a given subscriber.
+    template <typename Handler>
+    size_t Poll(unsigned int subscriber, Handler&& handler)
+    {
+        Queue& queue = *queues[subscriber];
+        GameEvent event;
+        size_t count = 0;
+
+        while (queue.Pop(event))
+        {
+            handler(event);
+            count++;
+        }
+        return count;
+    }
+
+private:
+    // Bounded multi-producer single-consumer ring, each cell has a sequence number
+    // telling whether it is free for the producers or ready for the consumer
+    class Queue
+    {
+    public:
+        explicit Queue(size_t capacity);
+        bool Push(const GameEvent& event);
+        bool Pop(GameEvent& event);
+
+    private:
+        struct Cell
+        {
+            atomic<size_t> sequence;
+            GameEvent event;
+        };
+
+        unique_ptr<Cell[]> cells;
+        size_t mask;
+        // Separate cache lines, the producers and the consumer don't share them
+        alignas(64) atomic<size_t> tail;
+        alignas(64) size_t head;
+    };
+
+    size_t capacity;
+    vector<unique_ptr<Queue>> queues;
+    atomic<unsigned long long> dropped;
+};
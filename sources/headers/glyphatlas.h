@@ -0,0 +1,68 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace sf;
+using namespace std;
+
+// Glyphs of the HUD rasterized once at load time into a single texture, so a new digit
+// or message never makes FreeType rasterize during a frame and all the texts are drawn in one batch
+class GlyphAtlas
+{
+public:
+    struct Glyph
+    {
+        float advance;
+        // Relative to the baseline, like sf::Glyph
+        FloatRect bounds;
+        // In the atlas, with GLYPH_ATLAS_PADDING pixels around the glyph, empty for a space
+        IntRect textureRect;
+    };
+
+    // Functions
+    // Characters needed at a size, before Build
+    void Add(unsigned int characterSize, const String& characters);
+    bool Build(const Font& font);
+    // nullptr if the character was not added at this size
+    const Glyph* Find(Uint32 character, unsigned int characterSize) const;
+    const Texture& GetTexture() const;
+    size_t GetGlyphCount() const;
+
+private:
+    vector<pair<unsigned int, String>> requests;
+    unordered_map<uint64_t, Glyph> glyphs;
+    Texture texture;
+
+    static uint64_t GetKey(Uint32 character, unsigned int characterSize);
+};
+
+// Space around the glyphs in the atlas, so the smoothing doesn't take pixels of the neighbors
+const int GLYPH_ATLAS_PADDING{ 1 };
@@ -0,0 +1,61 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Log-bucketed histogram of durations from 1 microsecond to 10 seconds, with about 1.5% precision.
+// Recording a value is a few instructions, so it can be done at each frame.
+class Histogram
+{
+public:
+    // Functions
+    Histogram();
+    void Record(double microseconds);
+    void Merge(const Histogram& other);
+    void Reset();
+    unsigned long long GetCount() const;
+    double GetMean() const;
+    double GetMax() const;
+    // Upper value of the bucket containing the given percentile (0 to 100)
+    double GetPercentile(double percentile) const;
+    // p50, p90, p99, p99.9 and max on one line
+    void Report(const string& name, ostream& stream) const;
+    bool SaveToFile(const string& fileName) const;
+    bool LoadFromFile(const string& fileName);
+
+private:
+    vector<unsigned long long> counts;
+    unsigned long long count;
+    double sum;
+    double maximum;
+
+    static size_t GetIndex(unsigned long long value);
+    static unsigned long long GetUpperValue(size_t index);
+};
\ No newline at end of file
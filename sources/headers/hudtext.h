@@ -0,0 +1,57 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "glyphatlas.h"
+#include <SFML/Graphics.hpp>
+
+using namespace sf;
+
+// Single line of text laid out from a glyph atlas, like an sf::Text without kerning.
+// Its quads are appended to a vertex array shared by all the texts.
+class HudText
+{
+public:
+    // Functions
+    HudText();
+    HudText(const String& string, const GlyphAtlas& atlas, unsigned int characterSize);
+    void SetString(const String& newString);
+    void SetCharacterSize(unsigned int newSize);
+    void SetFillColor(Color newColor);
+    void SetPosition(float x, float y);
+    // Same bounds as Text::getLocalBounds
+    FloatRect GetLocalBounds() const;
+    void Append(VertexArray& vertices) const;
+
+private:
+    const GlyphAtlas* atlas;
+    String string;
+    unsigned int characterSize;
+    Color color;
+    Vector2f position;
+    FloatRect bounds;
+
+    void UpdateBounds();
+};
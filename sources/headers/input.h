@@ -40,6 +40,10 @@ public:
         bool S;
         bool escape;
         bool space;
+        bool F3;
+        bool F4;
+        bool F5;
+        bool F6;
     };
 
     // Functions
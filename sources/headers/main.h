@@ -24,107 +24,65 @@
 
 #pragma once
 
+#include "ai.h"
+#include "archive.h"
+#include "assetloader.h"
 #include "ball.h"
+#include "batch.h"
+#include "bench.h"
+#include "codec.h"
+#include "determinism.h"
+#include "eventbus.h"
+#include "histogram.h"
+#include "hudtext.h"
 #include "input.h"
+#include "loadgen.h"
+#include "pacer.h"
+#include "metrics.h"
+#include "particles.h"
+#include "policy.h"
+#include "profiler.h"
 #include "racket.h"
+#include "relay.h"
+#include "searchai.h"
+#include "server.h"
+#include "settings.h"
+#include "simulation.h"
+#include "soak.h"
+#include "trace.h"
+#include "usage.h"
 #include "utils.h"
+#include "viewport.h"
+#include "voicepool.h"
 #include <iostream>
 #include <SFML/Graphics.hpp>
 
 using namespace sf;
 using namespace std;
 
-// Enums
-enum Collision { TopRacketL, BottomRacketL, RacketL, RacketR, TopRacketR, BottomRacketR, TopWindow, BottomWindow, LeftWindow, RightWindow, None };
-enum RacketDirection { Up, Down };
-enum BallDirection { Left, Right };
-enum Player { PlayerLeft, PlayerRight };
-
-// Window properties
-const string GAME_TITLE{ "Pong" };
-const unsigned int WINDOW_WIDTH{ 800 };
-const unsigned int WINDOW_HEIGHT{ 600 };
-const unsigned int FRAME_LIMIT{ 60 };
-
-// Game properties
-const Color PLAYER_L_COLOR{ Color::Blue };
-const Color PLAYER_R_COLOR{ Color::Red };
-const Color BALL_COLOR{ Color::White };
-const Player DEFAULT_PLAYER = PlayerRight;
-const unsigned int MAX_SCORE{ 10 };
-const float RACKET_L_SPEED{ 7.f };
-const float RACKET_R_SPEED{ 7.f };
-const float DEFAULT_BALL_SPEED{ 7.f };
-// With each collision with a racket, the speed of the ball increases by this value
-const float BALL_SPEED_INCREASE_VALUE{ 0.15f };
-
-// Sound properties (Volume)
-// Racket collision sound
-const float RACKET_SOUND_VOLUME{ 10.f };
-// Wall collision sound
-const float WALL_SOUND_VOLUME{ 10.f };
-
-// Left racket properties
-const unsigned int RACKET_L_WIDTH{ 16 };
-const unsigned int RACKET_L_HEIGHT{ 80 };
-const unsigned int DEFAULT_RACKET_L_POS_X{ 32 };
-const unsigned int DEFAULT_RACKET_L_POS_Y{ (WINDOW_HEIGHT / 2) - (RACKET_L_HEIGHT / 2) };
-// Minimum and maximum location of the racket
-const unsigned int RACKET_L_MIN_POS_Y{ 0 };
-const unsigned int RACKET_L_MAX_POS_Y{ WINDOW_HEIGHT - RACKET_L_HEIGHT };
-
-// Right racket properties
-const unsigned int RACKET_R_WIDTH{ 16 };
-const unsigned int RACKET_R_HEIGHT{ 80 };
-const unsigned int DEFAULT_RACKET_R_POS_X{ WINDOW_WIDTH - 32 - RACKET_R_WIDTH };
-const unsigned int DEFAULT_RACKET_R_POS_Y{ (WINDOW_HEIGHT / 2) - (RACKET_R_HEIGHT / 2) };
-// Minimum and maximum location of the racket
-const unsigned int RACKET_R_MIN_POS_Y{ 0 };
-const unsigned int RACKET_R_MAX_POS_Y{ WINDOW_HEIGHT - RACKET_R_HEIGHT };
-
-// Ball properties
-const float BALL_RADIUS{ 12.f };
-// Default location of the ball
-const unsigned int DEFAULT_BALL_POS_X{ static_cast<unsigned int>(WINDOW_WIDTH / 2.f - BALL_RADIUS / 2.f) };
-const unsigned int DEFAULT_BALL_POS_Y{ static_cast<unsigned int>(WINDOW_HEIGHT / 2.f - BALL_RADIUS) };
-
-// Score properties
-const unsigned int SCORE_FONT_SIZE{ 30 };
-
-// Text winner properties
-const unsigned int fontSizeWinner{ 54 };
-const String TEXT_WINNER_L{ "The Blue player win" };
-const String TEXT_WINNER_R{ "The Red player win" };
-
-// Text replay properties
-const unsigned int TEXT_REPLAY_FONT_SIZE{ 32 };
-const String TEXT_REPLAY{ "Press SPACEBAR to replay" };
-const Color TEXT_REPLAY_COLOR{ Color::White };
-
-// Text pause properties
-const unsigned int TEXT_PAUSE_FONT_SIZE{ 24 };
-const String TEXT_PAUSE{ "PAUSE" };
-const Color TEXT_PAUSE_COLOR{ Color::White };
-
-unsigned int collisionCount = 0;
-unsigned int scoreL, scoreR = 0;
-bool win = false;
-bool pause = false;
-
-float currentBallSpeed{ DEFAULT_BALL_SPEED };
-
-Vector2f currentDirection;
+bool paused = false;
+
+// Rules of the match, shared with the headless modes. The rackets and the ball only draw its state.
+Simulation simulation;
 
 // Object init
 // Window
 RenderWindow* window;
 
-// Texts
-Text textScoreL;
-Text textScoreR;
-Text textWinner;
-Text textReplay;
-Text textPause;
+// Waits for the end of each frame
+FramePacer pacer(FRAME_LIMIT, FRAME_PACING, PACER_SPIN_MICROSECONDS);
+
+// Logical space of the game, scaled to the window
+Viewport viewport(Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT), RENDER_SCALE_MIN, RENDER_SCALE_STEP, RENDER_SCALE_PROBE_FRAMES);
+
+// Texts, drawn from the glyph atlas in one batch
+GlyphAtlas hudAtlas;
+VertexArray hudVertices(Quads);
+HudText textScoreL;
+HudText textScoreR;
+HudText textWinner;
+HudText textReplay;
+HudText textPause;
 
 // Input
 Input* input;
@@ -136,20 +94,62 @@ Racket* racketR;
 // Ball
 Ball* ball;
 
-// Sound buffers
+// Computer players
+AI* cpuL;
+AI* cpuR;
+
+// Search computer players, only created if CPU_SEARCH is enabled
+ThreadPool* searchPool;
+SearchAI* searchL;
+SearchAI* searchR;
+
+// Learned computer players
+Policy* policy;
+
+// Time spent in each phase of the game loop
+Profiler* profiler;
+
+// Frame time, simulation time and input latency, printed when the game is closed
+Histogram frameHistogram;
+Histogram tickHistogram;
+Histogram latencyHistogram;
+
+// Processor time and power of the game, the pause and the end screens
+UsageMeter usage;
+
+// Events of the game, published by the physics
+EventBus events(EVENT_QUEUE_CAPACITY);
+
+// Effects of the hits and the points
+ParticleSystem particles(PARTICLE_CAPACITY);
+
+// Only created by --soak
+Soak* soakTest = nullptr;
+
+// Start of the program, for the startup times
+const chrono::steady_clock::time_point startupTime = chrono::steady_clock::now();
+
+// Packed assets, kept open while the font is used
+Archive assetArchive;
+
+// Sound buffers, synthesized at startup
 SoundBuffer racketBuffer;
 SoundBuffer wallBuffer;
 
 // Functions
-void CheckButton();
-Collision Intersect();
-void UpdateScore(Player player);
-void Winner();
+Input::Button CheckButton();
+void CpuControl(Input::Button& button, Player side);
+void UpdateScore(Player player, const Simulation::State& previous);
 void TogglePause();
 void Replay();
-
-// Asset locations
-const string assets_dir{ "assets/" };
-const string font_file{ assets_dir + "CodeNewRoman.otf" };
-const string racketSoundEffect{ assets_dir + "PaddleSound.wav" };
-const string wallSoundEffect{ assets_dir + "WallSound.wav" };
\ No newline at end of file
+void UpdateShapes();
+void PublishEvent(GameEvent::Type type, Player player, bool top);
+void PublishEvent(GameEvent::Type type, Player player, bool top, const Simulation::State& state);
+void UpdateHud(const GameEvent& gameEvent);
+void BuildHud();
+void RecordEvent(const GameEvent& gameEvent);
+void EmitParticles(const GameEvent& gameEvent);
+float GetSoundPitch(float ballSpeed);
+void ReportHistograms();
+double ShowLoadingScreen(const AssetLoader& assets);
+void ReportStartup(const AssetLoader& assets, double firstFrame, double loaded);
\ No newline at end of file
@@ -0,0 +1,77 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// Counters of the game served in the Prometheus text format by a small HTTP server on localhost.
+// The game thread only increments atomics, so a scrape never blocks a frame.
+class Metrics
+{
+public:
+    // Functions
+    static void Start(unsigned short port);
+    static void Stop();
+    static void RecordFrame(double microseconds);
+    static void AddTick();
+    static void AddRacketHit();
+    static void AddWallHit();
+    static void AddSoundPlay();
+    // Number of racket hits before the point was scored
+    static void EndRally(unsigned int hits);
+    static void AddMatch();
+    static void SetActiveMatches(unsigned int count);
+    // Body of the /metrics page
+    static string Format();
+
+private:
+    // Upper bounds of the frame time buckets (in seconds), the last bucket is +Inf
+    static constexpr size_t FRAME_BUCKET_COUNT{ 15 };
+    static const double FRAME_BUCKETS[FRAME_BUCKET_COUNT - 1];
+
+    static atomic<unsigned long long> frameCounts[FRAME_BUCKET_COUNT];
+    static atomic<unsigned long long> frames;
+    static atomic<double> frameSeconds;
+    static atomic<unsigned long long> ticks;
+    static atomic<unsigned long long> racketHits;
+    static atomic<unsigned long long> wallHits;
+    static atomic<unsigned long long> soundPlays;
+    static atomic<unsigned long long> rallies;
+    static atomic<unsigned long long> rallyHits;
+    static atomic<unsigned int> lastRally;
+    static atomic<unsigned int> longestRally;
+    static atomic<unsigned long long> matches;
+    static atomic<unsigned int> activeMatches;
+
+    static atomic<bool> running;
+    static thread* server;
+
+    static void Serve(unsigned short port);
+    static double GetFramePercentile(double percentile);
+};
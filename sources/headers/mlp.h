@@ -0,0 +1,73 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Inference of small fully connected networks (ReLU between layers, linear output).
+//
+// File format, little endian:
+// uint32 magic "PMLP", uint32 layer count, uint32 sizes[layer count + 1] (input size first),
+// then for each layer: float weights[output][input] and float biases[output].
+class Mlp
+{
+public:
+    static const unsigned int MAGIC = 0x504C4D50;
+
+    // Functions
+    Mlp();
+    bool LoadFromFile(const string& fileName);
+    size_t GetInputSize() const;
+    size_t GetOutputSize() const;
+    // Evaluate count inputs of GetInputSize() values into count outputs of GetOutputSize() values
+    void Evaluate(const float* inputs, float* outputs, size_t count);
+
+private:
+    // Number of floats in a SIMD register
+    static const size_t LANES = 8;
+
+    struct Layer
+    {
+        size_t inputSize;
+        size_t outputSize;
+        // Rounded up to the width of a SIMD register
+        size_t paddedSize;
+        // Transposed: weights[input][paddedSize], so that consecutive outputs are contiguous
+        vector<float> weights;
+        vector<float> biases;
+    };
+
+    vector<Layer> layers;
+    vector<float> bufferA;
+    vector<float> bufferB;
+
+    static void Forward(const Layer& layer, const float* inputs, size_t inputStride, float* outputs, size_t count, bool relu);
+    // Only called if the processor supports AVX2
+    static void ForwardAvx2(const Layer& layer, const float* inputs, size_t inputStride, float* outputs, size_t count, bool relu);
+};
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "histogram.h"
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+// Waits for the end of each frame. The hybrid mode sleeps until shortly before the frame boundary, then spins
+// on the monotonic clock to release the frame within a few microseconds of it.
+// The intervals between the frames are measured in every mode to compare their jitter.
+class FramePacer
+{
+public:
+    // Coarse: sleeps the rest of the period like setFramerateLimit, Hybrid: sleeps then spins,
+    // VerticalSync: doesn't wait, the display waits for the refresh of the screen
+    enum Mode { Coarse, Hybrid, VerticalSync };
+
+    // Functions
+    FramePacer(unsigned int frameRate, Mode mode, double spinMicroseconds);
+    // 0 for no limit
+    void SetFrameRate(unsigned int frameRate);
+    Mode GetMode() const;
+    // Called once per frame, after the display
+    void Wait();
+    // Starts the frame boundaries from now and doesn't measure the next interval (after a pause of the loop)
+    void Restart();
+    void ResetStatistics();
+    // Mean and standard deviation of the intervals, error from the period and late frames on one line
+    void Report(ostream& stream) const;
+
+private:
+    Mode mode;
+    chrono::steady_clock::duration period;
+    chrono::steady_clock::duration spin;
+    chrono::steady_clock::time_point next;
+    chrono::steady_clock::time_point last;
+    bool hasLast;
+
+    // Absolute difference between each interval and the period (microseconds)
+    Histogram errors;
+    double intervalSum;
+    double intervalSquareSum;
+    // Intervals longer than 1.5 periods, a frame shown twice
+    unsigned long long lateFrames;
+
+    void Record(chrono::steady_clock::time_point now);
+};
+
+// Compares the jitter and the processor time of each mode
+int RunPacing(int argc, char* argv[]);
@@ -0,0 +1,72 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace sf;
+using namespace std;
+
+// Effects of the hits and the points. The particles are stored by field (structure of arrays)
+// in a pool allocated once, updated 8 at a time and drawn with one vertex array.
+class ParticleSystem
+{
+public:
+    // Functions
+    explicit ParticleSystem(size_t capacity);
+    // Particles going in the directions from angle - spread / 2 to angle + spread / 2 (in radians),
+    // the particles that don't fit in the pool are not emitted
+    void Emit(Vector2f position, Color color, unsigned int count, float angle, float spread);
+    void Update(float seconds);
+    // Fill the vertex array with one quad per particle
+    void BuildVertices();
+    void Draw(RenderTarget& target) const;
+    void Clear();
+    size_t GetCount() const;
+    size_t GetCapacity() const;
+
+private:
+    // Number of floats in a SIMD register
+    static const size_t LANES = 8;
+
+    size_t capacity;
+    size_t count;
+    vector<float> positionX;
+    vector<float> positionY;
+    vector<float> velocityX;
+    vector<float> velocityY;
+    // Remaining time and inverse of the total time, for the fading
+    vector<float> life;
+    vector<float> inverseLifetime;
+    vector<Color> colors;
+    VertexArray vertices;
+    uint32_t random;
+
+    float NextRandom();
+    // Only called if the processor supports AVX2
+    size_t UpdateAvx2(float seconds, float drag);
+};
@@ -0,0 +1,57 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "input.h"
+#include "mlp.h"
+#include "settings.h"
+#include "simulation.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Learned racket controller: a network reading the match from the point of view of one racket
+// and returning the scores of the actions (none, up, down) like VecEnv.
+// The observation has the VecEnv layout seen from the right racket, it is mirrored for the left racket
+// so the same network can play both sides.
+class Policy
+{
+public:
+    // Functions
+    Policy();
+    bool LoadFromFile(const string& fileName);
+    bool IsLoaded() const;
+    // Decide the action of count rackets at once
+    void Act(const float* observations, unsigned char* actions, size_t count);
+    void Control(Input::Button& button, const Simulation::State& state, Player side);
+
+    static void Observe(const Simulation::State& state, Player side, float* observation);
+    static void Press(Input::Button& button, Player side, unsigned char action);
+
+private:
+    Mlp network;
+    vector<float> scores;
+};
\ No newline at end of file
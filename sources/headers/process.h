@@ -0,0 +1,58 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+using namespace std;
+
+// Counting the allocations replaces the global operator new and delete of the whole program, which adds a header
+// and two atomic operations to every allocation of every thread. It is only built with COUNT_ALLOCATIONS defined
+// (for the soak test and the metrics), otherwise the allocation counters stay at 0.
+#if defined(COUNT_ALLOCATIONS)
+const bool ALLOCATIONS_COUNTED{ true };
+#else
+const bool ALLOCATIONS_COUNTED{ false };
+#endif
+
+// Resources used by the process
+struct ProcessStats
+{
+    // Resident memory (bytes)
+    size_t resident;
+    // Open files, sockets... (Linux) or handles (Windows)
+    size_t handles;
+    // Counted by the global operator new and delete, 0 without COUNT_ALLOCATIONS
+    unsigned long long allocations;
+    unsigned long long liveAllocations;
+    unsigned long long liveBytes;
+};
+
+ProcessStats GetProcessStats();
+// Processor time used by all the threads of the process (seconds)
+double GetCpuTime();
+// Energy used by the processor package since an arbitrary point (joules), false if it can't be read
+// (only Linux with the RAPL counters readable)
+bool GetPackageEnergy(double& joules);
\ No newline at end of file
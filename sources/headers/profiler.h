@@ -0,0 +1,87 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+using namespace sf;
+using namespace std;
+
+// Time spent in each phase of the game loop over the last frames, with an overlay and a CSV export
+class Profiler
+{
+public:
+    enum Phase { Events, Buttons, Physics, Hud, Particles, Draw, Overlay, Display, Pacing, PhaseCount };
+
+    struct Frame
+    {
+        unsigned long long index;
+        // Microseconds
+        float total;
+        float phases[PhaseCount];
+    };
+
+    // Measure the time of a phase until the end of the scope.
+    // Nested scopes are subtracted from the enclosing one so every microsecond is counted once.
+    class Scope
+    {
+    public:
+        Scope(Profiler& profiler, Phase phase);
+        ~Scope();
+
+    private:
+        Profiler& profiler;
+        Phase phase;
+        Scope* parent;
+        chrono::steady_clock::time_point start;
+        float children;
+    };
+
+    // Functions
+    Profiler(const Font& font, size_t history);
+    void NextFrame();
+    void Toggle();
+    bool IsVisible() const;
+    void DrawOverlay(RenderTarget& target);
+    bool SaveToFile(const string& fileName) const;
+
+    static const char* GetPhaseName(Phase phase);
+
+private:
+    vector<Frame> frames;
+    size_t next;
+    size_t count;
+    Frame current;
+    Scope* active;
+    chrono::steady_clock::time_point frameStart;
+    bool visible;
+
+    RectangleShape background;
+    VertexArray graph;
+    Text text;
+};
\ No newline at end of file
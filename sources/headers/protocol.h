@@ -0,0 +1,83 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "codec.h"
+#include "input.h"
+#include "simulation.h"
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// Datagrams exchanged by the game server and its clients, bit-packed with the codec.
+// The first 3 bits are the type, ticks are sent modulo 65536.
+enum PacketType : unsigned char
+{
+    // Client -> server : join a match, or ask the welcome again if it was lost
+    PacketJoin = 1,
+    // Client -> server : buttons of the racket of the client
+    PacketInput = 2,
+    // Client -> server : leave the match
+    PacketLeave = 3,
+    // Server -> client : match and side given to the client
+    PacketWelcome = 4,
+    // Server -> client : state of the match after a tick
+    PacketState = 5
+};
+
+const unsigned int PACKET_TYPE_BITS{ 3 };
+const unsigned int TICK_BITS{ 16 };
+
+// Large enough for any packet
+const size_t MAX_PACKET_SIZE{ 64 };
+
+PacketType GetPacketType(const unsigned char* packet, size_t size);
+
+// Each function returns the size of the packet, the readers return 0 if the packet is invalid
+size_t WriteJoin(unsigned char* packet);
+size_t WriteInput(unsigned char* packet, uint32_t tick, const Input::Button& button);
+size_t ReadInput(const unsigned char* packet, size_t size, uint32_t& tick, Input::Button& button);
+size_t WriteLeave(unsigned char* packet);
+size_t WriteWelcome(unsigned char* packet, uint32_t match, Player side);
+size_t ReadWelcome(const unsigned char* packet, size_t size, uint32_t& match, Player& side);
+size_t WriteState(unsigned char* packet, uint32_t tick, const Simulation::State& state);
+size_t ReadState(const unsigned char* packet, size_t size, uint32_t& tick, Simulation::State& state);
+
+// Frames streamed to the spectators over TCP : 1 byte of length, then the type (1 bit), the tick and the state.
+// A delta only contains the fields changed since the previous frame, a keyframe contains all of them.
+enum FrameType : unsigned char
+{
+    FrameKeyframe = 0,
+    FrameDelta = 1
+};
+
+// Length, then the largest delta: all the fields and their mask
+const size_t MAX_FRAME_SIZE{ 1 + (1 + TICK_BITS + STATE_FIELD_COUNT + STATE_BITS + 7) / 8 };
+
+size_t WriteKeyframe(unsigned char* frame, uint32_t tick, const Simulation::State& state);
+size_t WriteDelta(unsigned char* frame, uint32_t tick, const Simulation::State& previous, const Simulation::State& state);
+// Size of the whole frame, or 0 if it is incomplete or invalid. A delta is applied to the state of the previous frame.
+size_t ReadFrame(const unsigned char* frame, size_t size, uint32_t& tick, Simulation::State& state, FrameType& type);
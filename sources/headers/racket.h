@@ -38,4 +38,5 @@ public:
 	void Move(int direction, float speed);
 	RectangleShape GetShape();
 	Vector2f GetPosition();
+	void SetPosition(Vector2f position);
 };
\ No newline at end of file
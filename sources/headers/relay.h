@@ -0,0 +1,114 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "histogram.h"
+#include "simulation.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Streams matches to spectators over TCP (Linux only, epoll).
+// Each tick is encoded once in an immutable buffer shared by all the spectators of the match, and written from it
+// with writev: nothing is copied per spectator. A spectator that does not read fast enough has its queue dropped
+// and receives a keyframe instead. A relay is driven by one thread, run one per core for more spectators.
+class Relay
+{
+public:
+    // Encoded frame shared by the queues of the spectators
+    struct Snapshot
+    {
+        uint32_t tick;
+        bool keyframe;
+        vector<unsigned char> bytes;
+    };
+
+    // Since the previous call to CollectStats
+    struct Stats
+    {
+        unsigned int spectators;
+        unsigned long long ticks;
+        unsigned long long frames;
+        unsigned long long bytes;
+        // Keyframes queued for new or dropped spectators
+        unsigned long long keyframes;
+        // Queues dropped because the spectator was too slow
+        unsigned long long drops;
+        // Time to encode a tick and write it to all the spectators (in microseconds)
+        Histogram publishHistogram;
+    };
+
+    // Functions
+    Relay();
+    ~Relay();
+    bool Listen(unsigned short port);
+    // Accept the new spectators and read their subscriptions, without blocking
+    void Poll();
+    void Publish(uint32_t match, uint32_t tick, const Simulation::State& state);
+    Stats CollectStats();
+
+private:
+    struct Spectator
+    {
+        int socket;
+        // Match chosen by the spectator, sent as 4 bytes after the connection
+        bool subscribed;
+        uint32_t match;
+        size_t index;
+        unsigned char request[4];
+        size_t requestSize;
+        deque<shared_ptr<const Snapshot>> queue;
+        // Bytes of the first frame of the queue already sent
+        size_t offset;
+        bool needsKeyframe;
+    };
+
+    struct Channel
+    {
+        bool published;
+        Simulation::State previous;
+        vector<Spectator*> spectators;
+    };
+
+    int listener;
+    int epoll;
+    unordered_map<int, unique_ptr<Spectator>> spectators;
+    unordered_map<uint32_t, Channel> channels;
+    Stats stats;
+
+    void Read(Spectator& spectator);
+    void Enqueue(Spectator& spectator, const shared_ptr<const Snapshot>& delta, const shared_ptr<const Snapshot>& keyframe);
+    bool Write(Spectator& spectator);
+    void Remove(Spectator& spectator);
+};
+
+// --relay [port] : streams an AI vs AI match, as match 0
+int RunRelay(int argc, char* argv[]);
+// --relay-bench [spectators] [seconds] : spectators on localhost, some of them stalled, and the CPU time of the relay
+int RunRelayBench(int argc, char* argv[]);
@@ -0,0 +1,75 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "ai.h"
+#include "input.h"
+#include "settings.h"
+#include "simulation.h"
+#include "threadpool.h"
+#include <vector>
+
+using namespace std;
+
+// Computer player that plays each possible move on copies of the match and keeps the best one.
+// The rollouts are spread over a thread pool and stop when the time budget of the frame is spent,
+// the predictive AI decides when no rollout could be finished.
+class SearchAI
+{
+public:
+    enum Move { Stay, MoveUp, MoveDown, MoveCount };
+
+    struct Stats
+    {
+        unsigned long long decisions;
+        unsigned long long rollouts;
+        unsigned long long frames;
+        unsigned long long overBudget;
+        unsigned long long fallbacks;
+        double seconds;
+    };
+
+    // Functions
+    SearchAI(Player side, ThreadPool& pool, float budgetMs = SEARCH_BUDGET_MS, unsigned int seed = 0);
+    void Reset();
+    void Observe(Collision collision, const Simulation::State& state);
+    void Control(Input::Button& button, const Simulation::State& state);
+    const Stats& GetStats() const;
+
+private:
+    Player side;
+    ThreadPool& pool;
+    float budgetMs;
+    unsigned int seed;
+    unsigned int rollouts;
+    AI fallback;
+    vector<float> values;
+    // Frames stepped by each rollout, 0 if it was not run
+    vector<unsigned int> finished;
+    Stats stats;
+
+    float Rollout(const Simulation::State& state, Move move, unsigned int rolloutSeed, unsigned int& frames) const;
+    void Press(Input::Button& button, Move move) const;
+};
\ No newline at end of file
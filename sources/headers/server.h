@@ -0,0 +1,70 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "histogram.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Headless server hosting many matches of two UDP clients (Linux only, epoll).
+// Each worker thread owns an event loop, a socket bound to the shared port (SO_REUSEPORT, so the kernel spreads
+// the clients over the workers) and the matches of its clients: nothing is shared between the workers.
+class GameServer
+{
+public:
+    // Sum of the workers since the previous call to CollectStats
+    struct Stats
+    {
+        unsigned int workers;
+        unsigned int matches;
+        unsigned int clients;
+        unsigned long long ticks;
+        // Ticks skipped because the previous one was too long
+        unsigned long long lateTicks;
+        unsigned long long packetsReceived;
+        unsigned long long packetsSent;
+        // Time to step and broadcast all the matches of a worker (in microseconds)
+        Histogram tickHistogram;
+    };
+
+    // Functions
+    GameServer();
+    ~GameServer();
+    bool Start(unsigned short port, unsigned int workerCount);
+    void Stop();
+    Stats CollectStats();
+
+private:
+    struct Worker;
+
+    vector<unique_ptr<Worker>> workers;
+    atomic<bool> running;
+};
+
+// --server [port] [workers] : runs the server and prints its stats every few seconds
+int RunServer(int argc, char* argv[]);
@@ -0,0 +1,251 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "pacer.h"
+#include "synth.h"
+#include <SFML/Graphics.hpp>
+#include <string>
+
+using namespace sf;
+using namespace std;
+
+// Enums
+enum Collision { TopRacketL, BottomRacketL, RacketL, RacketR, TopRacketR, BottomRacketR, TopWindow, BottomWindow, LeftWindow, RightWindow, None };
+enum RacketDirection { Up, Down };
+enum BallDirection { Left, Right };
+enum Player { PlayerLeft, PlayerRight };
+
+// Window properties
+const string GAME_TITLE{ "Pong" };
+const unsigned int WINDOW_WIDTH{ 800 };
+const unsigned int WINDOW_HEIGHT{ 600 };
+const unsigned int FRAME_LIMIT{ 60 };
+// Hybrid: sleeps then spins until each frame boundary, Coarse: only sleeps (like setFramerateLimit),
+// VerticalSync: waits for the refresh of the screen (the jitter is measured against FRAME_LIMIT)
+const FramePacer::Mode FRAME_PACING{ FramePacer::Hybrid };
+// End of each frame spent spinning instead of sleeping (microseconds), more precise but uses more processor time
+const double PACER_SPIN_MICROSECONDS{ 2000.0 };
+// The game is computed in WINDOW_WIDTH x WINDOW_HEIGHT logical pixels and scaled to the size of the window,
+// with black bars to keep the ratio
+const bool WINDOW_RESIZABLE{ true };
+// Resolution of the rendering relative to the window, lowered by steps down to RENDER_SCALE_MIN when the frames are late
+const bool DYNAMIC_RENDER_SCALE{ true };
+const float RENDER_SCALE_MIN{ 0.5f };
+const float RENDER_SCALE_STEP{ 0.1f };
+// Frames at the frame rate before trying the next higher resolution
+const unsigned int RENDER_SCALE_PROBE_FRAMES{ 120 };
+// On the pause and the end screens, a frame is drawn only after an event (key, resize, focus) instead of at the frame rate
+const bool IDLE_RENDERING{ true };
+
+// Game properties
+const Color PLAYER_L_COLOR{ Color::Blue };
+const Color PLAYER_R_COLOR{ Color::Red };
+const Color BALL_COLOR{ Color::White };
+const Player DEFAULT_PLAYER = PlayerRight;
+const unsigned int MAX_SCORE{ 10 };
+const float RACKET_L_SPEED{ 7.f };
+const float RACKET_R_SPEED{ 7.f };
+const float DEFAULT_BALL_SPEED{ 7.f };
+// With each collision with a racket, the speed of the ball increases by this value
+const float BALL_SPEED_INCREASE_VALUE{ 0.15f };
+// Particles of the hits and the points
+const unsigned int PARTICLE_CAPACITY{ 8192 };
+const float PARTICLE_SIZE{ 3.f };
+// Maximum lifetime (in seconds) and speed (in pixels per second)
+const float PARTICLE_LIFETIME{ 0.6f };
+const float PARTICLE_SPEED{ 300.f };
+// Fraction of the speed kept after one second
+const float PARTICLE_DRAG{ 0.05f };
+// Number of particles emitted by each event
+const unsigned int RACKET_HIT_PARTICLES{ 40 };
+const unsigned int WALL_HIT_PARTICLES{ 20 };
+const unsigned int SCORE_PARTICLES{ 300 };
+
+// Capacity of the queue of each consumer of the game events (sounds, texts, metrics), an event is dropped if it is full
+const unsigned int EVENT_QUEUE_CAPACITY{ 256 };
+
+// Sound properties (Volume)
+// Racket collision sound
+const float RACKET_SOUND_VOLUME{ 10.f };
+// Wall collision sound
+const float WALL_SOUND_VOLUME{ 10.f };
+
+// Sound voices, a sound steals the voice of a sound of lower or equal priority when they are all playing
+const unsigned int SOUND_VOICES{ 16 };
+const unsigned int RACKET_SOUND_PRIORITY{ 2 };
+const unsigned int WALL_SOUND_PRIORITY{ 1 };
+// Minimum time between two plays of the same sound (in seconds)
+const float RACKET_SOUND_MIN_INTERVAL{ 0.03f };
+const float WALL_SOUND_MIN_INTERVAL{ 0.03f };
+// Stereo width of the panning from the ball position, 0 for centered sounds and 1 for fully left or right at the edges
+const float SOUND_PAN{ 0.8f };
+
+// Synthesized sounds : waveform, frequency, attack, decay, sustain level, hold, release and amplitude
+const unsigned int SYNTH_SAMPLE_RATE{ 44100 };
+const SynthPatch RACKET_SOUND_PATCH{ Square, 459.f, 0.002f, 0.015f, 0.6f, 0.04f, 0.03f, 0.5f };
+const SynthPatch WALL_SOUND_PATCH{ Square, 226.f, 0.002f, 0.015f, 0.6f, 0.03f, 0.03f, 0.5f };
+// The pitch of the sounds grows with the ball speed, it is 1 + this value at twice the starting speed
+const float SOUND_PITCH_SPEED{ 0.5f };
+const float SOUND_MAX_PITCH{ 2.f };
+
+// Left racket properties
+const unsigned int RACKET_L_WIDTH{ 16 };
+const unsigned int RACKET_L_HEIGHT{ 80 };
+const unsigned int DEFAULT_RACKET_L_POS_X{ 32 };
+const unsigned int DEFAULT_RACKET_L_POS_Y{ (WINDOW_HEIGHT / 2) - (RACKET_L_HEIGHT / 2) };
+// Minimum and maximum location of the racket
+const unsigned int RACKET_L_MIN_POS_Y{ 0 };
+const unsigned int RACKET_L_MAX_POS_Y{ WINDOW_HEIGHT - RACKET_L_HEIGHT };
+
+// Right racket properties
+const unsigned int RACKET_R_WIDTH{ 16 };
+const unsigned int RACKET_R_HEIGHT{ 80 };
+const unsigned int DEFAULT_RACKET_R_POS_X{ WINDOW_WIDTH - 32 - RACKET_R_WIDTH };
+const unsigned int DEFAULT_RACKET_R_POS_Y{ (WINDOW_HEIGHT / 2) - (RACKET_R_HEIGHT / 2) };
+// Minimum and maximum location of the racket
+const unsigned int RACKET_R_MIN_POS_Y{ 0 };
+const unsigned int RACKET_R_MAX_POS_Y{ WINDOW_HEIGHT - RACKET_R_HEIGHT };
+
+// Ball properties
+const float BALL_RADIUS{ 12.f };
+// Default location of the ball
+const unsigned int DEFAULT_BALL_POS_X{ static_cast<unsigned int>(WINDOW_WIDTH / 2.f - BALL_RADIUS / 2.f) };
+const unsigned int DEFAULT_BALL_POS_Y{ static_cast<unsigned int>(WINDOW_HEIGHT / 2.f - BALL_RADIUS) };
+
+// Score properties
+const unsigned int SCORE_FONT_SIZE{ 30 };
+
+// Text winner properties
+const unsigned int fontSizeWinner{ 54 };
+const String TEXT_WINNER_L{ "The Blue player win" };
+const String TEXT_WINNER_R{ "The Red player win" };
+
+// Text replay properties
+const unsigned int TEXT_REPLAY_FONT_SIZE{ 32 };
+const String TEXT_REPLAY{ "Press SPACEBAR to replay" };
+const Color TEXT_REPLAY_COLOR{ Color::White };
+
+// Text pause properties
+const unsigned int TEXT_PAUSE_FONT_SIZE{ 24 };
+const String TEXT_PAUSE{ "PAUSE" };
+const Color TEXT_PAUSE_COLOR{ Color::White };
+
+// Asset locations
+const string assets_dir{ "assets/" };
+const string font_file{ assets_dir + "CodeNewRoman.otf" };
+// Packed assets, searched next to the executable then in the working directory. Without it, the files above are loaded.
+const string ASSET_ARCHIVE{ "assets.pak" };
+
+// Asset loading, 0 uses one thread per core
+const unsigned int ASSET_LOAD_THREADS{ 0 };
+// Progress bar of the loading screen
+const Vector2f LOADING_BAR_SIZE{ 400.f, 8.f };
+const Color LOADING_BAR_COLOR{ Color::White };
+
+// CPU player properties
+// If enabled, the racket is controlled by the computer instead of the keyboard
+const bool CPU_PLAYER_L{ false };
+const bool CPU_PLAYER_R{ false };
+// Number of frames the computer waits after a bounce before moving its racket
+const unsigned int CPU_REACTION_DELAY{ 6 };
+// Maximum aiming error of the computer (in pixels)
+const float CPU_AIM_ERROR{ 20.f };
+
+// Search CPU player properties
+// If enabled, the computer players simulate the next frames for each possible move instead of only predicting the ball
+const bool CPU_SEARCH{ false };
+// Number of frames simulated by each rollout
+const unsigned int SEARCH_HORIZON{ 240 };
+// Number of frames the tested move is held before the rollout plays like the predictive CPU
+const unsigned int SEARCH_COMMIT_FRAMES{ 12 };
+// Maximum number of rollouts for each move
+const unsigned int SEARCH_ROLLOUTS{ 64 };
+// Time allowed to the search at each frame (in milliseconds)
+const float SEARCH_BUDGET_MS{ 1.f };
+
+// Learned CPU player properties
+// Network file of a policy trained with VecEnv, used by the computer players instead of the other AIs if not empty
+const string CPU_POLICY_FILE{ "" };
+
+// Profiler properties (F3 : toggle the overlay, F4 : save to CSV)
+// Number of frames kept by the profiler
+const unsigned int PROFILER_HISTORY{ 240 };
+const string PROFILER_FILE{ "profile.csv" };
+
+// Trace properties (F5 : save the trace)
+// If enabled, the game loop, the loading and the sounds are recorded in the Chrome trace format, saved when the game is closed
+const bool TRACE_ENABLED{ false };
+// Number of events kept for each thread
+const unsigned int TRACE_BUFFER_EVENTS{ 1 << 18 };
+const string TRACE_FILE{ "trace.json" };
+// Soak test properties (--soak [minutes] [interval])
+// Duration of the test and time between two samples (in seconds)
+const float SOAK_DURATION{ 600.f };
+const float SOAK_INTERVAL{ 5.f };
+// Part of the samples ignored at the start, while the caches and the allocators warm up
+const float SOAK_WARMUP{ 0.25f };
+// A resource is leaking if it never decreases on this part of the samples...
+const float SOAK_MONOTONIC{ 0.9f };
+// ...and ends higher than it started by more than this part of its value
+const float SOAK_MIN_GROWTH{ 0.05f };
+// The tick time is creeping if the p99 of the last third is this many times the one of the first third
+const float SOAK_LATENCY_CREEP{ 1.5f };
+const string SOAK_FILE{ "soak.csv" };
+
+// Determinism check properties (--determinism, --determinism-record, --determinism-verify)
+// Number of frames replayed and seed of the computer players that generate the inputs
+const unsigned int DETERMINISM_TICKS{ 100000 };
+const unsigned int DETERMINISM_SEED{ 1 };
+
+// Metrics properties
+// If enabled, the counters of the game are served in the Prometheus text format on http://localhost:METRICS_PORT/metrics
+const bool METRICS_ENABLED{ false };
+const unsigned short METRICS_PORT{ 9400 };
+
+// Game server properties (--server [port] [workers], --loadgen [max matches] [workers] [client threads])
+const unsigned short SERVER_PORT{ 27015 };
+// Ticks per second of each match
+const unsigned int SERVER_TICK_RATE{ 60 };
+// Number of event loops, 0 to use one per core
+const unsigned int SERVER_WORKERS{ 0 };
+// A client that sends nothing during this time leaves its match (in seconds)
+const float SERVER_CLIENT_TIMEOUT{ 5.f };
+// Matches added at each step of the load generator, and duration of a step (in seconds)
+const unsigned int LOADGEN_STEP{ 250 };
+const float LOADGEN_STEP_DURATION{ 3.f };
+const unsigned int LOADGEN_MAX_MATCHES{ 20000 };
+
+// Spectator relay properties (--relay [port], --relay-bench [spectators] [seconds])
+const unsigned short RELAY_PORT{ 27016 };
+// Frames waiting for a spectator, above that it is too slow : its frames are dropped and it gets a keyframe
+const unsigned int RELAY_QUEUE_LIMIT{ 32 };
+// Kernel send buffer of each spectator (in bytes), kept small so a slow spectator is detected by its queue
+const int RELAY_SOCKET_BUFFER{ 4096 };
+// A keyframe is sent to all the spectators every this many ticks
+const unsigned int RELAY_KEYFRAME_INTERVAL{ 600 };
+const unsigned int RELAY_BENCH_SPECTATORS{ 10000 };
+// Part of the spectators of the benchmark that stop reading during the measurement
+const float RELAY_BENCH_STALLED{ 0.01f };
@@ -0,0 +1,64 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "input.h"
+#include "settings.h"
+#include <SFML/System.hpp>
+
+using namespace sf;
+
+// Rules of a match, played by the game loop and by the headless modes (batch, search, server, determinism...).
+// No window, sound or delays: the game adds them around Step().
+class Simulation
+{
+public:
+    struct State
+    {
+        Vector2f ballPosition;
+        Vector2f direction;
+        float ballSpeed;
+        float racketLY;
+        float racketRY;
+        unsigned int scoreL;
+        unsigned int scoreR;
+        unsigned int collisionCount;
+        bool win;
+    };
+
+    // Functions
+    Simulation();
+    void Reset();
+    Collision Step(const Input::Button& button);
+    Collision Intersect() const;
+    const State& GetState() const;
+    void SetState(const State& newState);
+
+private:
+    State state;
+
+    void UpdateScore(Player player);
+    void Serve();
+};
\ No newline at end of file
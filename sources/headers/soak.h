@@ -0,0 +1,74 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "histogram.h"
+#include "process.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Long AI vs AI run of the real game loop. The memory, the handles and the tick time are sampled
+// at regular intervals to find what grows over time.
+class Soak
+{
+public:
+    // Functions
+    Soak(float duration, float interval);
+    void RecordFrame(double microseconds);
+    void RecordTick(double microseconds);
+    void AddMatch();
+    // Take a sample if the interval is elapsed, false when the test is over
+    bool Update();
+    // Save the samples to CSV and print the resources that grow, returns 1 if any
+    int Report(const string& fileName) const;
+
+private:
+    struct Sample
+    {
+        double elapsed;
+        unsigned int matches;
+        ProcessStats stats;
+        double tickP50;
+        double tickP99;
+        double frameP50;
+        double frameP99;
+    };
+
+    float duration;
+    float interval;
+    chrono::steady_clock::time_point start;
+    chrono::steady_clock::time_point lastSample;
+    unsigned int matches;
+    // Reset at each sample
+    Histogram tickHistogram;
+    Histogram frameHistogram;
+    vector<Sample> samples;
+
+    void TakeSample(chrono::steady_clock::time_point now);
+    bool IsGrowing(const vector<double>& values, size_t first) const;
+};
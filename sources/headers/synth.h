@@ -0,0 +1,63 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <vector>
+
+using namespace sf;
+using namespace std;
+
+enum Waveform { Sine, Square, Triangle, Noise };
+
+// Oscillator and ADSR envelope of a synthesized sound (times in seconds)
+struct SynthPatch
+{
+    Waveform waveform;
+    // In Hz
+    float frequency;
+    float attack;
+    float decay;
+    // Level of the sustain, from 0 to 1
+    float sustain;
+    // Duration of the sustain
+    float hold;
+    float release;
+    // Peak amplitude, from 0 to 1
+    float amplitude;
+};
+
+// Small synthesizer generating the sound effects at startup, instead of decoding files
+class Synth
+{
+public:
+    // Functions
+    // Mono 16-bit samples of the patch
+    static void Generate(const SynthPatch& patch, unsigned int sampleRate, vector<Int16>& samples);
+    static bool Generate(const SynthPatch& patch, unsigned int sampleRate, SoundBuffer& buffer);
+
+private:
+    static float Envelope(const SynthPatch& patch, float time);
+};
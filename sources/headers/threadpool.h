@@ -0,0 +1,69 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Fixed set of worker threads sharing a range of work with the calling thread
+class ThreadPool
+{
+public:
+    // Functions
+    explicit ThreadPool(unsigned int threads = 0);
+    ~ThreadPool();
+    unsigned int GetThreadCount() const;
+
+    // Call task(begin, end) on one slice of [0, count) per thread and wait for all of them.
+    // The task is passed by address so no allocation is done per call.
+    template <typename Task>
+    void ParallelFor(size_t count, Task& task)
+    {
+        Run(count, [](void* context, size_t begin, size_t end) { (*static_cast<Task*>(context))(begin, end); }, &task);
+    }
+
+private:
+    typedef void (*TaskFunction)(void* context, size_t begin, size_t end);
+
+    unsigned int threadCount;
+    vector<thread> workers;
+    mutex taskMutex;
+    condition_variable wakeCondition;
+    condition_variable doneCondition;
+    TaskFunction task = nullptr;
+    void* taskContext = nullptr;
+    size_t taskCount = 0;
+    size_t pending = 0;
+    unsigned long long generation = 0;
+    bool stop = false;
+
+    void Run(size_t count, TaskFunction function, void* context);
+    void Work(size_t index);
+};
\ No newline at end of file
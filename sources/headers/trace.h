@@ -0,0 +1,97 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Timeline of the game in the Chrome trace event format (chrome://tracing, ui.perfetto.dev).
+// Each thread writes in its own ring buffer without lock, only the registration of a new thread locks.
+// Names are not copied: they must be string literals.
+class Trace
+{
+public:
+    // Span from the constructor to the end of the scope
+    class Span
+    {
+    public:
+        explicit Span(const char* name);
+        ~Span();
+
+    private:
+        const char* name;
+        long long start;
+    };
+
+    // Functions
+    static void Enable(bool enabled);
+    static bool IsEnabled();
+    static void SetThreadName(const char* name);
+    static void Complete(const char* name, chrono::steady_clock::time_point start, chrono::steady_clock::time_point end);
+    static void Instant(const char* name);
+    static void Counter(const char* name, double value);
+    static bool SaveToFile(const string& fileName);
+
+private:
+    enum Type : char { CompleteEvent = 'X', InstantEvent = 'i', CounterEvent = 'C' };
+
+    struct Event
+    {
+        const char* name;
+        // Nanoseconds since the start of the program
+        long long timestamp;
+        // Nanoseconds for a span, value for a counter
+        union
+        {
+            long long duration;
+            double value;
+        };
+        Type type;
+    };
+
+    struct ThreadBuffer
+    {
+        unsigned int id;
+        const char* name;
+        vector<Event> events;
+        atomic<unsigned long long> written;
+    };
+
+    static atomic<bool> enabled;
+    // Buffers of all the threads, kept until the end of the program so they can be saved after a thread exits
+    static mutex buffersMutex;
+    static vector<unique_ptr<ThreadBuffer>>* buffers;
+
+    static long long Now();
+    static long long ToNanoseconds(chrono::steady_clock::time_point time);
+    static ThreadBuffer& GetBuffer();
+    static void Write(const Event& event);
+};
\ No newline at end of file
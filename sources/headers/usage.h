@@ -0,0 +1,66 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+// Time, frames, processor time and energy spent in each state of the game,
+// to compare the cost of the game screen with the pause and the end screens.
+class UsageMeter
+{
+public:
+    enum State { Playing, Paused, Won, StateCount };
+
+    // Functions
+    UsageMeter();
+    // Starts a new period if the state changed
+    void SetState(State newState);
+    void AddFrame();
+    // One line per state, the current period included
+    void Report(ostream& stream) const;
+
+private:
+    struct Usage
+    {
+        double seconds;
+        double cpuSeconds;
+        double joules;
+        unsigned long long frames;
+    };
+
+    State state;
+    chrono::steady_clock::time_point start;
+    double cpuStart;
+    double energyStart;
+    bool hasEnergy;
+    Usage usages[StateCount];
+
+    // Usage of the current state since its start
+    Usage GetCurrent() const;
+};
@@ -24,12 +24,14 @@
 
 #pragma once
 
+#include "archive.h"
+#include "hudtext.h"
 #include <SFML/Graphics.hpp>
-#include <SFML/Audio.hpp>
 
 using namespace std;
 using namespace sf;
 
 
 void SetText(Text& text, const String& str);
-bool LoadSound(SoundBuffer& buffer, const string& fileName);
\ No newline at end of file
+void SetText(HudText& text, const String& str);
+bool LoadFont(Font& font, const Archive& archive, const string& fileName);
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "simulation.h"
+#include "threadpool.h"
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// Steps many headless matches at once for reinforcement learning.
+// All the buffers belong to the caller and are laid out per match:
+// actions      : ACTION_SIZE values (left racket, right racket)
+// observations : OBSERVATION_SIZE values (ball x, ball y, direction x, direction y, ball speed, left racket y, right racket y)
+// rewards      : REWARD_SIZE values (left player, right player), +1 for the player who scores and -1 for the other
+// dones        : 1 when the match was won during this step, the match is then reset automatically
+class VecEnv
+{
+public:
+    enum Action : unsigned char { ActionNone, ActionUp, ActionDown };
+
+    static const size_t ACTION_SIZE = 2;
+    static const size_t OBSERVATION_SIZE = 7;
+    static const size_t REWARD_SIZE = 2;
+
+    // Functions
+    VecEnv(size_t count, unsigned int threads = 0);
+    size_t GetCount() const;
+    unsigned int GetThreadCount() const;
+    const Simulation::State& GetState(size_t index) const;
+    void Reset(float* observations);
+    void Step(const unsigned char* actions, float* observations, float* rewards, unsigned char* dones);
+
+    static void Observe(const Simulation::State& state, float* observation);
+
+private:
+    vector<Simulation> simulations;
+    ThreadPool pool;
+};
\ No newline at end of file
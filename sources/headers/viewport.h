@@ -0,0 +1,73 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+using namespace sf;
+
+// Renders the scene, computed in a fixed logical space, into a texture scaled to fit the output
+// (window or offscreen texture) with black bars to keep the ratio.
+// The resolution of the texture is lowered when the frames miss their budget and raised back step by step.
+class Viewport
+{
+public:
+    // Functions
+    Viewport(Vector2f logicalSize, float minimumScale, float scaleStep, unsigned int probeFrames);
+    // Size of the output in pixels, returns false if the scene texture can't be created
+    bool Resize(Vector2u outputSize);
+    // Adapts the render scale to the time of the last frame, returns true if the scale changed
+    bool Update(double frameMicroseconds, double budgetMicroseconds);
+    // Target of the scene, in logical coordinates
+    RenderTexture& GetScene();
+    // Draws the scene in the letterbox of the output
+    void Present(RenderTarget& output);
+    // Logical view drawn in the letterbox, to draw on the output without the scene texture
+    View GetLetterboxView() const;
+    float GetScale() const;
+    Vector2u GetSceneSize() const;
+
+private:
+    Vector2f logicalSize;
+    float minimumScale;
+    float scaleStep;
+    unsigned int probeFrames;
+    Vector2u outputSize;
+    // Area of the output covered by the scene, in pixels
+    FloatRect letterbox;
+    RenderTexture scene;
+    Sprite sprite;
+    // Number of steps under the full resolution
+    unsigned int level;
+    unsigned int maxLevel;
+    double averageFrame;
+    unsigned int stableFrames;
+    // Frames at the budget before trying the next resolution, doubled each time it fails
+    unsigned int probeInterval;
+    bool probing;
+
+    bool CreateScene();
+};
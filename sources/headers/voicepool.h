@@ -0,0 +1,85 @@
+/*
+    MIT License
+
+    Copyright (c) 2024 Alexandre Foret (https://www.alexandreforet.pro)
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+using namespace sf;
+using namespace std;
+
+// Fixed set of voices shared by the sound effects. A new sound takes a free voice, or steals the
+// voice of the lowest priority closest to its end, so quick collisions no longer cut each other off.
+class VoicePool
+{
+public:
+    struct Stats
+    {
+        unsigned long long plays;
+        // Playing voices taken by a new sound
+        unsigned long long steals;
+        // Triggers ignored because the effect was played too recently
+        unsigned long long rateLimited;
+        // Triggers ignored because every voice plays a sound of higher priority
+        unsigned long long dropped;
+    };
+
+    // Functions
+    VoicePool(unsigned int voiceCount);
+    // The buffer is copied (and mixed to mono so it can be panned), returns the id of the effect
+    unsigned int AddEffect(const SoundBuffer& buffer, float volume, unsigned int priority, float minInterval);
+    // Play an effect panned from the x position in the window, false if it was not played
+    bool Play(unsigned int effect, float x, float pitch = 1.f);
+    void StopAll();
+    const Stats& GetStats() const;
+
+private:
+    struct Effect
+    {
+        SoundBuffer buffer;
+        float volume;
+        unsigned int priority;
+        chrono::steady_clock::duration length;
+        chrono::steady_clock::duration minInterval;
+        chrono::steady_clock::time_point lastPlay;
+    };
+
+    struct Voice
+    {
+        Sound sound;
+        unsigned int priority;
+        // Computed from the length of the buffer, cheaper than asking OpenAL for the status
+        chrono::steady_clock::time_point end;
+    };
+
+    // The voices keep a pointer to the buffers, a deque doesn't move them when an effect is added
+    deque<Effect> effects;
+    vector<Voice> voices;
+    Stats stats;
+
+    size_t FindVoice(unsigned int priority, chrono::steady_clock::time_point now);
+};